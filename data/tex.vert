@@ -4,12 +4,24 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
+// define MVP_TRANSFORM to transform with separate model, view and projection matrix
+// instead of a single transform matrix
+#ifdef MVP_TRANSFORM
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+#else
 uniform mat4 transform;
+#endif
 
 out vec2 vsTexCoord;
 
 void main()
 {
+#ifdef MVP_TRANSFORM
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+#else
     gl_Position = transform * vec4(aPos, 1.0);
+#endif
     vsTexCoord = aTexCoord;
 }
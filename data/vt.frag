@@ -0,0 +1,37 @@
+#version 330 core
+
+// sample virtual texture streamed by lgl::VirtualTexture, uniforms are set by VirtualTexture::Bind()
+uniform sampler2D vtPageTable;
+uniform sampler2D vtPhysical;
+uniform vec4 vtInfo;        // pages of level 0 (xy), the coarsest level (z), lod bias (w)
+uniform vec2 vtUvScale;     // image over its padded size
+uniform vec4 vtPage;        // page size, border, slot size, physical cache size in texels
+
+in vec2 vsTexCoord;
+
+out vec4 fsColor;
+
+// the same level as data/vt_feedback.frag requests
+float VtLevel(vec2 uv)
+{
+    vec2 texels = uv * vtInfo.xy * vtPage.x;
+    vec2 dx = dFdx(texels);
+    vec2 dy = dFdy(texels);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + vtInfo.w;
+    return clamp(floor(lod), 0.0, vtInfo.z);
+}
+
+vec4 VtSample(vec2 texCoord)
+{
+    vec2 uv = clamp(texCoord, 0.0, 1.0) * vtUvScale;
+    // page table entry points to slot of the page, or of its nearest resident coarser page
+    vec4 entry = floor(textureLod(vtPageTable, uv, VtLevel(uv)) * 255.0 + 0.5);
+    vec2 pages = vtInfo.xy / exp2(entry.b);
+    vec2 texel = entry.rg * vtPage.z + vtPage.y + fract(uv * pages) * vtPage.x;
+    return textureLod(vtPhysical, texel / vtPage.w, 0.0);
+}
+
+void main()
+{
+    fsColor = VtSample(vsTexCoord);
+}
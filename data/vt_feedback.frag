@@ -0,0 +1,31 @@
+#version 330 core
+
+// write page of virtual texture each pixel needs, read back by lgl::VirtualTexture.
+// Uniforms are set by VirtualTexture::BindFeedback().
+uniform vec4 vtInfo;        // pages of level 0 (xy), the coarsest level (z), lod bias (w)
+uniform vec2 vtUvScale;     // image over its padded size
+uniform vec4 vtPage;        // page size, border, slot size, physical cache size in texels
+
+in vec2 vsTexCoord;
+
+out vec4 fsColor;
+
+// the same level as data/vt.frag samples
+float VtLevel(vec2 uv)
+{
+    vec2 texels = uv * vtInfo.xy * vtPage.x;
+    vec2 dx = dFdx(texels);
+    vec2 dy = dFdy(texels);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + vtInfo.w;
+    return clamp(floor(lod), 0.0, vtInfo.z);
+}
+
+void main()
+{
+    vec2 uv = clamp(vsTexCoord, 0.0, 1.0) * vtUvScale;
+    float level = VtLevel(uv);
+    vec2 pages = vtInfo.xy / exp2(level);
+    vec2 page = min(floor(uv * pages), pages - 1.0);
+    // alpha marks the pixel as requesting a page
+    fsColor = vec4(page, level, 255.0) / 255.0;
+}
@@ -0,0 +1,79 @@
+#ifndef _BAKED_TEXTURE_H_
+#define _BAKED_TEXTURE_H_
+
+#include <cstdint>
+
+namespace lgl
+{
+namespace baked
+{
+
+/*
+====================
+Baked texture container
+====================
+*/
+
+/**
+ * Layout of texture container (.lgt) written by src/TextureBaker, and loaded by
+ * lgl::util::LoadBakedTexture(). All levels are ready to be uploaded as they are, already flipped
+ * vertically as lgl::util::LoadTexture() does, and with full mipmap chain.
+ *
+ * [FileHeader][LevelHeader x numLevels][padding][level 0 data][padding][level 1 data]...
+ *
+ * All fields are little-endian. Data of each level starts at offset aligned to kDataAlignment.
+ */
+
+const char kMagic[4] = { 'L', 'G', 'L', 'T' };
+const std::uint32_t kVersion = 1;
+const std::uint32_t kDataAlignment = 16;
+
+enum Format
+{
+    FORMAT_RGB8 = 1,        // uncompressed, tightly packed rows
+    FORMAT_RGBA8 = 2,       // uncompressed
+    FORMAT_BC1 = 3,         // DXT1, 8 bytes per 4x4 block, no alpha
+    FORMAT_BC3 = 4          // DXT5, 16 bytes per 4x4 block, with alpha
+};
+
+struct FileHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t format;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t numLevels;
+};
+
+struct LevelHeader
+{
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint64_t offset;   // from the beginning of file
+    std::uint64_t size;     // in bytes
+};
+
+static_assert(sizeof(FileHeader) == 24, "FileHeader must have no padding as it's written to file as it is");
+static_assert(sizeof(LevelHeader) == 24, "LevelHeader must have no padding as it's written to file as it is");
+
+/**
+ * Size in bytes of a level of input format and dimension.
+ */
+inline std::uint64_t GetLevelSize(std::uint32_t format, std::uint32_t width, std::uint32_t height)
+{
+    const std::uint64_t numBlocks = static_cast<std::uint64_t>((width + 3) / 4) * ((height + 3) / 4);
+    switch (format)
+    {
+    case FORMAT_RGB8: return static_cast<std::uint64_t>(width) * height * 3;
+    case FORMAT_RGBA8: return static_cast<std::uint64_t>(width) * height * 4;
+    case FORMAT_BC1: return numBlocks * 8;
+    case FORMAT_BC3: return numBlocks * 16;
+    default: return 0;
+    }
+}
+
+}
+}
+
+#endif // _BAKED_TEXTURE_H_
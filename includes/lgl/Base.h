@@ -6,7 +6,31 @@
 #include "lgl/Util.h"
 #include "lgl/Error.h"
 #include "lgl/Shader.h"
+#include "lgl/UniformBlock.h"
+#include "lgl/Ext.h"
+#include "lgl/ProgramCache.h"
+#include "lgl/ShaderRegistry.h"
+#include "lgl/ShaderWatcher.h"
+#include "lgl/ThreadPool.h"
+#include "lgl/TextureLoader.h"
+#include "lgl/PixelBufferRing.h"
+#include "lgl/TextureCache.h"
+#include "lgl/Mipmap.h"
+#include "lgl/TextureAtlas.h"
+#include "lgl/Vfs.h"
+#include "lgl/VirtualTexture.h"
+#include "lgl/Sampler.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/SpscRing.h"
+#include "lgl/DebugOutput.h"
+#include "lgl/Log.h"
+#include "lgl/SnapshotBuffer.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
 
 // include the most frequently used at this level
 #define LGL_EXTERNAL_GLM_INCLUDE
@@ -24,12 +48,67 @@ namespace lgl
         bool RelativeMouseCursor;
         bool MouseScrollEnabled;
 
+        // directory to cache linked shader program binaries into, nullptr to disable.
+        // See lgl::ProgramCache.
+        const char* ProgramCacheDir;
+
+        // create debug context, and receive OpenGL errors via lgl::DebugOutput instead of
+        // polling glGetError() after each call. See lgl::DebugOutput.
+        bool DebugContext;
+
+        // update simulation at this fixed rate regardless of frame rate, 0 to update once per frame
+        // with time since previous frame. See App::UserRenderInterpolated().
+        double FixedUpdateHz;
+        // most updates per frame to catch up when frame takes longer than update, time beyond is dropped
+        int MaxUpdateSteps;
+
+        // number of screen refreshes to wait for before swapping buffers, 0 to disable vsync.
+        // -1 for adaptive vsync which swaps right away when frame is late instead of waiting for
+        // next refresh, falls back to 1 if not supported.
+        int SwapInterval;
+        // limit frame rate by sleeping until next frame is due, 0 to not limit. Useful with
+        // vsync disabled, or when display refreshes faster than needed.
+        double TargetFps;
+        // block waiting for events instead of rendering frames nothing changed in. Frame is rendered
+        // on input, window resize/expose, or App::RequestRedraw(). For apps mostly at rest, not for
+        // continuous animation.
+        bool IdleWhenUnchanged;
+        // seconds to wait for events at most when idle, UserUpdate() still runs after each wait
+        double IdleTimeout;
+
+        // call UserUpdate() on its own thread at FixedUpdateHz (60 if not set), so it overlaps with
+        // rendering and waiting for swap. It must not call OpenGL nor GLFW, and hands state over to
+        // UserRender() via lgl::SnapshotBuffer. UserProcessKeyInput() and mouse callbacks stay on
+        // main thread, once per frame. See App::GetRenderAlpha().
+        bool UpdateThread;
+
         AppConfigs(): MousePosEnabled(false),
                       RelativeMouseCursor(false),
-                      MouseScrollEnabled(false)
+                      MouseScrollEnabled(false),
+                      ProgramCacheDir(nullptr),
+                      DebugContext(false),
+                      FixedUpdateHz(0.0),
+                      MaxUpdateSteps(5),
+                      SwapInterval(1),
+                      TargetFps(0.0),
+                      IdleWhenUnchanged(false),
+                      IdleTimeout(0.25),
+                      UpdateThread(false)
         { }
     };
 
+    /**
+     * Counters of App main loop, see App::GetFrameStats().
+     */
+    struct FrameStats
+    {
+        unsigned long long framesRendered;
+        unsigned long long framesSkipped;   // loop iterations not rendered as nothing changed
+        double secondsIdle;                 // blocked waiting for events
+        double secondsSleeping;             // slept by frame limiter
+        double secondsSpinning;             // busy-waited by frame limiter for precise timing
+    };
+
     /*
     ====================
     App instance
@@ -41,6 +120,14 @@ namespace lgl
         int Setup(const char* title, const lgl::AppConfigs& configs=lgl::AppConfigs());
         void Start();
         GLFWwindow* GetGLFWWindow() const;
+        // render next frame when AppConfigs::IdleWhenUnchanged is set, safe to call from any thread
+        void RequestRedraw();
+        FrameStats GetFrameStats() const;
+        // time simulation reaches by the current update, call it within UserUpdate()
+        double GetUpdateTime() const;
+        // how far now is between update that reached snapshotTime and the next one in [0, 1], to
+        // interpolate snapshot of that update in UserRender(). 1 without fixed update rate.
+        double GetRenderAlpha(double snapshotTime) const;
 
         // ------------ user-callback ---------------- //
         virtual void UserFramebufferSizeCallback(const int width, const int height);
@@ -48,8 +135,12 @@ namespace lgl
         virtual void UserProcessMousePos(float xOffset, float yOffset);
         virtual void UserProcessMouseScrollInput(float xOffset, float yOffset);
         virtual void UserSetup();
-        virtual void UserUpdate(double delta);    // delta in seconds
+        virtual void UserUpdate(double delta);    // delta in seconds, fixed step if AppConfigs::FixedUpdateHz is set
         virtual void UserRender();
+        // alpha in [0, 1) is how far time is between the last two updates, render state interpolated
+        // between them by alpha for smooth motion with fixed update rate. It's 1 without fixed update
+        // rate. Default calls UserRender(). It's 1 with update thread, use GetRenderAlpha() instead.
+        virtual void UserRenderInterpolated(double alpha);
         virtual void UserShutdown();
         // ------------ end of user-callback --------- //
 
@@ -64,15 +155,37 @@ namespace lgl
         static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
         static void MouseCallback(GLFWwindow* window, double xpos, double ypos);
         static void MouseScrollCallback(GLFWwindow* window, double xOffset, double yOffset);
+        // installed only when idle, to wake up on input
+        static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+        static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+        static void IdleMouseCallback(GLFWwindow* window, double xpos, double ypos);
+        static void WindowRefreshCallback(GLFWwindow* window);
 
         // mouse control
         float lastMouseX;
         float lastMouseY;
 
         void ProcessKeyInput(GLFWwindow* window, double deltaTime);
+        void WaitForNextFrame();
+        void UpdateThreadMain();
 
         TmpHolder holder;
         double prevTicks;
+        double fixedStep;       // seconds, 0 if update once per frame
+        int maxUpdateSteps;
+        double updateTime;      // time simulation reached, written only by thread calling UserUpdate()
+        bool updateThreadEnabled;
+        std::atomic<bool> updateThreadStop;
+
+        // frame pacing
+        double framePeriod;     // seconds, 0 if not limited
+        double nextFrameTime;
+        double sleepMargin;     // woken up this much before frame is due then spin, adapts to oversleep
+        bool idleWhenUnchanged;
+        double idleTimeout;
+        std::atomic<bool> redrawRequested;
+        int numInputsHeld;      // keys and mouse buttons held down, keep rendering while any is
+        FrameStats frameStats;
     };
 }
 
@@ -87,6 +200,8 @@ inline int lgl::App::Setup(const char* title, const lgl::AppConfigs& configs)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (configs.DebugContext)
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
     GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, title, nullptr, nullptr);
     if (window == nullptr)
@@ -105,6 +220,21 @@ inline int lgl::App::Setup(const char* title, const lgl::AppConfigs& configs)
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, lgl::App::FramebufferSizeCallback);
 
+    // negative interval is adaptive vsync, only valid with swap control tear extension
+    int swapInterval = configs.SwapInterval;
+    if (swapInterval < 0 && !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        swapInterval = -swapInterval;
+    glfwSwapInterval(swapInterval);
+
+    framePeriod = configs.TargetFps > 0.0 ? 1.0 / configs.TargetFps : 0.0;
+    sleepMargin = 0.001;
+    idleWhenUnchanged = configs.IdleWhenUnchanged;
+    idleTimeout = configs.IdleTimeout;
+    // always render the first frame
+    redrawRequested.store(true);
+    numInputsHeld = 0;
+    frameStats = FrameStats();
+
     if (configs.MousePosEnabled)
     {
         glfwSetCursorPosCallback(window, lgl::App::MouseCallback);
@@ -113,6 +243,14 @@ inline int lgl::App::Setup(const char* title, const lgl::AppConfigs& configs)
     }
     if (configs.MouseScrollEnabled)
         glfwSetScrollCallback(window, lgl::App::MouseScrollCallback);
+    if (configs.IdleWhenUnchanged)
+    {
+        glfwSetKeyCallback(window, lgl::App::KeyCallback);
+        glfwSetMouseButtonCallback(window, lgl::App::MouseButtonCallback);
+        glfwSetWindowRefreshCallback(window, lgl::App::WindowRefreshCallback);
+        if (!configs.MousePosEnabled)
+            glfwSetCursorPosCallback(window, lgl::App::IdleMouseCallback);
+    }
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -120,6 +258,14 @@ inline int lgl::App::Setup(const char* title, const lgl::AppConfigs& configs)
         glfwTerminate();
         return -1;
     }
+    lgl::ext::Load((GLADloadproc)glfwGetProcAddress);
+    fixedStep = configs.FixedUpdateHz > 0.0 ? 1.0 / configs.FixedUpdateHz : (configs.UpdateThread ? 1.0 / 60.0 : 0.0);
+    updateThreadEnabled = configs.UpdateThread;
+    maxUpdateSteps = configs.MaxUpdateSteps > 0 ? configs.MaxUpdateSteps : 1;
+    lgl::ProgramCache::SetDirectory(configs.ProgramCacheDir);
+    // falls back to glGetError() if not supported
+    if (configs.DebugContext)
+        lgl::DebugOutput::Enable();
 
     glViewport(0, 0, 800, 600);
 
@@ -150,6 +296,7 @@ inline void lgl::App::MouseCallback(GLFWwindow* window, double xpos, double ypos
     float yOffset = app->lastMouseY - ypos;
     app->lastMouseX = xpos;
     app->lastMouseY = ypos;
+    app->RequestRedraw();
 
     static float kSensitivity = 0.05f;
     xOffset *= kSensitivity;
@@ -161,6 +308,7 @@ inline void lgl::App::MouseCallback(GLFWwindow* window, double xpos, double ypos
 inline void lgl::App::MouseScrollCallback(GLFWwindow* window, double xOffset, double yOffset)
 {
     lgl::App *app = static_cast<lgl::App*>(glfwGetWindowUserPointer(window));
+    app->RequestRedraw();
     app->UserProcessMouseScrollInput(xOffset, yOffset);
 }
 
@@ -169,9 +317,64 @@ inline void lgl::App::FramebufferSizeCallback(GLFWwindow* window, int width, int
     glViewport(0, 0, width, height);
 
     lgl::App *app = static_cast<lgl::App*>(glfwGetWindowUserPointer(window));
+    app->RequestRedraw();
     app->UserFramebufferSizeCallback(width, height);
 }
 
+inline void lgl::App::KeyCallback(GLFWwindow* window, int, int, int action, int)
+{
+    lgl::App *app = static_cast<lgl::App*>(glfwGetWindowUserPointer(window));
+    // held keys are polled in UserProcessKeyInput() every frame, so keep rendering until released
+    if (action == GLFW_PRESS)
+        ++app->numInputsHeld;
+    else if (action == GLFW_RELEASE && app->numInputsHeld > 0)
+        --app->numInputsHeld;
+    app->RequestRedraw();
+}
+
+inline void lgl::App::MouseButtonCallback(GLFWwindow* window, int, int action, int)
+{
+    KeyCallback(window, 0, 0, action, 0);
+}
+
+inline void lgl::App::IdleMouseCallback(GLFWwindow* window, double, double)
+{
+    lgl::App *app = static_cast<lgl::App*>(glfwGetWindowUserPointer(window));
+    app->RequestRedraw();
+}
+
+inline void lgl::App::WindowRefreshCallback(GLFWwindow* window)
+{
+    lgl::App *app = static_cast<lgl::App*>(glfwGetWindowUserPointer(window));
+    app->RequestRedraw();
+}
+
+inline void lgl::App::RequestRedraw()
+{
+    redrawRequested.store(true);
+    // wake up main loop if it's waiting for events
+    if (idleWhenUnchanged)
+        glfwPostEmptyEvent();
+}
+
+inline lgl::FrameStats lgl::App::GetFrameStats() const
+{
+    return frameStats;
+}
+
+inline double lgl::App::GetUpdateTime() const
+{
+    return updateTime;
+}
+
+inline double lgl::App::GetRenderAlpha(double snapshotTime) const
+{
+    if (fixedStep <= 0.0)
+        return 1.0;
+    const double alpha = (glfwGetTime() - snapshotTime) / fixedStep;
+    return alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha);
+}
+
 inline void lgl::App::ProcessKeyInput(GLFWwindow* window, double deltaTime)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -182,32 +385,168 @@ inline void lgl::App::ProcessKeyInput(GLFWwindow* window, double deltaTime)
     UserProcessKeyInput(deltaTime);
 }
 
+inline void lgl::App::WaitForNextFrame()
+{
+    // longest expected oversleep of OS, and shortest margin to keep spinning for
+    static const double kMaxSleepMargin = 0.004;
+    static const double kMinSleepMargin = 0.0002;
+
+    double now = glfwGetTime();
+    nextFrameTime += framePeriod;
+    if (nextFrameTime <= now)
+    {
+        // late, start over from now rather than rush frames to catch up
+        nextFrameTime = now;
+        return;
+    }
+
+    // sleep is cheap but imprecise, wake up a bit early then spin the rest
+    const double sleepUntil = nextFrameTime - sleepMargin;
+    if (sleepUntil > now)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(sleepUntil - now));
+        const double woken = glfwGetTime();
+        frameStats.secondsSleeping += woken - now;
+        // widen margin right away on oversleep, narrow it slowly back
+        const double overslept = woken - sleepUntil;
+        if (overslept > sleepMargin)
+            sleepMargin = std::min(overslept * 1.5, kMaxSleepMargin);
+        else
+            sleepMargin = std::max(sleepMargin * 0.95, kMinSleepMargin);
+        now = woken;
+    }
+
+    const double spinStart = now;
+    while (now < nextFrameTime)
+    {
+        std::this_thread::yield();
+        now = glfwGetTime();
+    }
+    frameStats.secondsSpinning += now - spinStart;
+}
+
+inline void lgl::App::UpdateThreadMain()
+{
+    while (!updateThreadStop.load())
+    {
+        // the same stepping as main loop does without update thread, time is kept in updateTime
+        const double now = glfwGetTime();
+        int numSteps = 0;
+        while (updateTime + fixedStep <= now && numSteps < maxUpdateSteps)
+        {
+            updateTime += fixedStep;
+            UserUpdate(fixedStep);
+            ++numSteps;
+        }
+        if (updateTime + fixedStep <= now)
+            updateTime = now - std::fmod(now - updateTime, fixedStep);
+
+        // no spinning, render interpolates by time of snapshot so late wake up isn't visible
+        const double wait = updateTime + fixedStep - glfwGetTime();
+        if (wait > 0.0)
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+}
+
 inline void lgl::App::Start()
 {
-    prevTicks = 0.0;
+    prevTicks = glfwGetTime();
+    nextFrameTime = prevTicks;
+    updateTime = prevTicks;
+    double accumulator = 0.0;
+
+    std::thread updateThread;
+    if (updateThreadEnabled)
+    {
+        updateThreadStop.store(false);
+        updateThread = std::thread(&lgl::App::UpdateThreadMain, this);
+    }
 
     while (!glfwWindowShouldClose(holder.window))
     {
         // get window
         GLFWwindow* window = holder.window;
 
-        glfwPollEvents();
+        if (framePeriod > 0.0)
+            WaitForNextFrame();
 
-        double delta = glfwGetTime() - prevTicks; 
-        // update input
-        ProcessKeyInput(window, delta);
-        // update main loop
-        UserUpdate(delta);
-        prevTicks = glfwGetTime();
+        if (idleWhenUnchanged && !redrawRequested.load() && numInputsHeld == 0)
+        {
+            // nothing to show, block until input, RequestRedraw(), or timeout for UserUpdate()
+            const double waitStart = glfwGetTime();
+            glfwWaitEventsTimeout(idleTimeout);
+            frameStats.secondsIdle += glfwGetTime() - waitStart;
+        }
+        else
+        {
+            glfwPollEvents();
+        }
+
+        const double now = glfwGetTime();
+        const double delta = now - prevTicks;
+        prevTicks = now;
+
+        double alpha = 1.0;
+        if (updateThreadEnabled)
+        {
+            // GLFW input is main thread only, UserUpdate() runs on update thread
+            ProcessKeyInput(window, delta);
+        }
+        else if (fixedStep > 0.0)
+        {
+            // consume elapsed time in fixed steps, the remainder carries over to next frame
+            accumulator += delta;
+            int numSteps = 0;
+            while (accumulator >= fixedStep && numSteps < maxUpdateSteps)
+            {
+                ProcessKeyInput(window, fixedStep);
+                updateTime += fixedStep;
+                UserUpdate(fixedStep);
+                accumulator -= fixedStep;
+                ++numSteps;
+            }
+            // too slow to catch up, drop the backlog instead of falling further behind
+            if (accumulator >= fixedStep)
+                accumulator = std::fmod(accumulator, fixedStep);
+            updateTime = now - accumulator;
+            alpha = accumulator / fixedStep;
+        }
+        else
+        {
+            // update input
+            ProcessKeyInput(window, delta);
+            // update main loop
+            updateTime = now;
+            UserUpdate(delta);
+        }
+
+        // skip frame if nothing changed since the last one
+        if (idleWhenUnchanged && !redrawRequested.exchange(false) && numInputsHeld == 0)
+        {
+            ++frameStats.framesSkipped;
+            continue;
+        }
 
         // render
-        UserRender();
+        UserRenderInterpolated(alpha);
         // not that useful, but should give visual feedback to user
 
         glfwSwapBuffers(window);
+        ++frameStats.framesRendered;
+
+        // print errors reported by driver during this frame
+        if (lgl::DebugOutput::IsEnabled())
+            lgl::DebugOutput::Drain();
+    }
+
+    if (updateThread.joinable())
+    {
+        updateThreadStop.store(true);
+        updateThread.join();
     }
 
     UserShutdown();
+    lgl::DebugOutput::Disable();
     glfwTerminate();
 }
 
@@ -218,6 +557,10 @@ inline void lgl::App::UserRender()
     glClear(GL_COLOR_BUFFER_BIT);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 }
+inline void lgl::App::UserRenderInterpolated(double)
+{
+    UserRender();
+}
 inline void lgl::App::UserShutdown() { }
 
 inline void lgl::App::UserProcessKeyInput(double) { }
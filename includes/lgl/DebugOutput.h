@@ -0,0 +1,89 @@
+#ifndef _DEBUG_OUTPUT_H_
+#define _DEBUG_OUTPUT_H_
+
+#include "Wrapped_GL.h"
+#include "Ext.h"
+
+namespace lgl
+{
+
+/**
+ * Counters of DebugOutput, see DebugOutput::GetStats().
+ */
+struct DebugOutputStats
+{
+    unsigned int received;      // messages driver called back with
+    unsigned int dropped;       // messages lost as ring was full, drain more often if it grows
+    unsigned int drained;       // messages printed by Drain()
+};
+
+/*
+====================
+Debug output
+====================
+*/
+
+/**
+ * OpenGL errors and warnings reported by driver through callback (GL_KHR_debug), instead of
+ * polling glGetError() after each call which waits for driver to catch up.
+ *
+ * Callback only copies message into a fixed lock-free ring, then Drain() prints them once per frame
+ * on thread that owns OpenGL context. lgl::App drains it after UserRender() when it's enabled via
+ * lgl::AppConfigs::DebugContext.
+ *
+ * Driver is only required to report everything on debug context, so LGL_AnyGLErrorMsgOnly skips
+ * glGetError() only when it's enabled on such context.
+ */
+class DebugOutput
+{
+public:
+    static const unsigned int kMaxMessageLength = 256;      // longer message is truncated
+    static const unsigned int kRingCapacity = 256;
+
+    /**
+     * Start receiving messages, call this after lgl::ext::Load().
+     *
+     * \param minSeverity Least severe messages to receive, GL_DEBUG_SEVERITY_NOTIFICATION for all
+     * \param synchronous Whether driver calls back from within offending call, slower but its call
+     * stack then points at the culprit in debugger
+     * \return Return 0 for success, otherwise LGL_FAIL if driver doesn't support GL_KHR_debug or
+     * minSeverity is not a GL_DEBUG_SEVERITY_* value.
+     */
+    static int Enable(GLenum minSeverity = GL_DEBUG_SEVERITY_LOW, bool synchronous = false);
+
+    /**
+     * Stop receiving messages, and print what's left in ring.
+     */
+    static void Disable();
+
+    static bool IsEnabled();
+
+    /**
+     * Enable or disable messages matching source, type and severity. Driver won't generate
+     * disabled ones at all.
+     *
+     * \param source i.e. GL_DEBUG_SOURCE_API, or GL_DONT_CARE for all sources
+     * \param type i.e. GL_DEBUG_TYPE_PERFORMANCE, or GL_DONT_CARE for all types
+     * \param severity i.e. GL_DEBUG_SEVERITY_LOW, or GL_DONT_CARE for all severities
+     * \param enabled Whether to receive them
+     */
+    static void Filter(GLenum source, GLenum type, GLenum severity, bool enabled);
+
+    /**
+     * Print all messages received so far via lgl::error::ErrorWarn(), or ErrorPrint() for errors and
+     * high severity ones so they are never rate-limited.
+     * It does nothing but checking ring is empty when there is none.
+     *
+     * \return Number of messages printed
+     */
+    static unsigned int Drain();
+
+    static DebugOutputStats GetStats();
+
+private:
+    static void APIENTRY Callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
+};
+
+}
+
+#endif // _DEBUG_OUTPUT_H_
@@ -7,6 +7,7 @@
 #include <cstdarg>
 #include "lgl/Wrapped_GL.h"
 #include "lgl/Types.h"
+#include "lgl/Log.h"
 
 // based on checking status code equals to 0 or not
 // for other variant, we need more of these
@@ -20,8 +21,9 @@
 #define LGL_ERROR_QUIT(ret, msg)
 #endif
 
+// glGetError() waits for driver, skip it when driver reports errors via lgl::DebugOutput instead
 #ifndef LGL_NODEBUG
-#define LGL_AnyGLErrorMsgOnly lgl::error::AnyGLError();
+#define LGL_AnyGLErrorMsgOnly if (!lgl::error::IsDebugOutputEnabled()) { lgl::error::AnyGLError(); }
 #else
 #define LGL_AnyGLErrorMsgOnly
 #endif
@@ -34,37 +36,49 @@ namespace lgl
 Error handler
 ====================
 */
+
+/**
+ * Messages go through lgl::log, so they are thread-safe and cheap on calling thread, but printed
+ * a little later by its writer thread. fmt must be string literal, see lgl::log::Write().
+ */
 class error
 {
 public:
     static const int ERROR_BUFFER = 1024;
 
-    static inline void ErrorWarn(const char *fmt, ...)
+    template <typename... Args>
+    static inline void ErrorWarn(const char *fmt, const Args&... args)
     {
-        va_list ap;
-
-        va_start(ap, fmt);
-        error::ErrorDoIt(fmt, ap);
-        va_end(ap);
+#if LGL_LOG_LEVEL <= LGL_LOG_LEVEL_WARN
+        lgl::log::Write(lgl::log::SEVERITY_WARN, fmt, args...);
+#endif
     }
 
-    static inline void ErrorDump(const char *fmt, ...)
+    /**
+     * Print error without terminating. Unlike ErrorWarn(), it's never suppressed by rate limit of
+     * lgl::log, for diagnostics whose every instance matters i.e. shader compilation errors.
+     */
+    template <typename... Args>
+    static inline void ErrorPrint(const char *fmt, const Args&... args)
     {
-        va_list ap;
+#if LGL_LOG_LEVEL <= LGL_LOG_LEVEL_ERROR
+        lgl::log::Write(lgl::log::SEVERITY_ERROR, fmt, args...);
+#endif
+    }
 
-        va_start(ap, fmt);
-        error::ErrorDoIt(fmt, ap);
-        va_end(ap);
+    template <typename... Args>
+    static inline void ErrorDump(const char *fmt, const Args&... args)
+    {
+        lgl::log::Write(lgl::log::SEVERITY_ERROR, fmt, args...);
+        lgl::log::Flush();
         std::abort();   // dump core and terminate
     }
 
-    static inline void ErrorExit(const char *fmt, ...)
+    template <typename... Args>
+    static inline void ErrorExit(const char *fmt, const Args&... args)
     {
-        va_list ap;
-
-        va_start(ap, fmt);
-        error::ErrorDoIt(fmt, ap);
-        va_end(ap);
+        lgl::log::Write(lgl::log::SEVERITY_ERROR, fmt, args...);
+        lgl::log::Flush();
         std::exit(1);
     }
 
@@ -129,15 +143,18 @@ public:
      */
     static inline GLint AnyGLShaderError(const GLuint shader)
     {
+        GLint status = GL_FALSE;
         glGetShaderiv(shader, GL_COMPILE_STATUS, &status);  
 
         if (!status)
         {
 #ifndef LGL_NODEBUG
+            char errLog[ERROR_BUFFER];
             glGetShaderInfoLog(shader, ERROR_BUFFER, nullptr, errLog);
-            ErrorWarn("GL compilation error: %s",errLog);
+            ErrorPrint("GL compilation error: %s", errLog);
 #endif
-            return status;
+            // status itself is GL_FALSE which is the same as LGL_SUCCESS
+            return LGL_FAIL;
         }
 
         return LGL_SUCCESS;
@@ -155,42 +172,37 @@ public:
      */
     static inline GLint AnyGLShaderProgramError(const GLuint shaderProgram)
     {
+        GLint status = GL_FALSE;
         glGetProgramiv(shaderProgram, GL_LINK_STATUS, &status);
         if (!status)
         {
 #ifndef LGL_NODEBUG
+            char errLog[ERROR_BUFFER];
             glGetProgramInfoLog(shaderProgram, ERROR_BUFFER, nullptr, errLog);
-            ErrorWarn("GL shader program linking error: %s", errLog);
+            ErrorPrint("GL shader program linking error: %s", errLog);
 #endif
-            return status;
+            return LGL_FAIL;
         }
 
         return LGL_SUCCESS;
     }
 
-private:
-    static GLint status;
-    static char errLog[ERROR_BUFFER];
-
-    static inline void ErrorDoIt(const char *fmt, va_list ap)
+    /**
+     * Whether OpenGL errors are reported through lgl::DebugOutput on debug context, then
+     * LGL_AnyGLErrorMsgOnly doesn't poll glGetError(). lgl::DebugOutput sets this.
+     */
+    static inline bool IsDebugOutputEnabled()
     {
-        char buf[ERROR_BUFFER + 1];
-
-        int errnoSave = errno;
-        std::vsnprintf( buf, ERROR_BUFFER, fmt, ap );     // don't make sense to still check if snprintf is available
-
-        int n = strlen( buf );
-        // get error string if it related to system call error
-        if (!errnoSave) {
-            std::snprintf( buf + n, ERROR_BUFFER - n + 1, ": %s", std::strerror( errnoSave ) );
-        }
-        std::strncat( buf, "\n", 1 );
+        return debugOutputEnabled;
+    }
 
-        // flush relavant output streams
-        std::fflush( stdout );
-        std::fputs( buf, stderr );
-        std::fflush( stderr );
+    static inline void SetDebugOutputEnabled(bool enabled)
+    {
+        debugOutputEnabled = enabled;
     }
+
+private:
+    static bool debugOutputEnabled;
 };
 
 }
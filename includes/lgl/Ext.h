@@ -0,0 +1,142 @@
+#ifndef _EXT_H_
+#define _EXT_H_
+
+#include "Wrapped_GL.h"
+
+/**
+ * OpenGL functions and enums beyond OpenGL 3.3 core that glad is generated for.
+ * They are optional, so check whether each one is available before use i.e. via
+ * lgl::ext::HasProgramBinary().
+ */
+
+// GL_ARB_get_program_binary (core since 4.1)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// GL_KHR_parallel_shader_compile, or GL_ARB_parallel_shader_compile with the same enums
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// GL_EXT_texture_compression_s3tc
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// GL_KHR_debug (core since 4.3)
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#endif
+#ifndef GL_DEBUG_OUTPUT_SYNCHRONOUS
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#endif
+#ifndef GL_CONTEXT_FLAG_DEBUG_BIT
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#endif
+#ifndef GL_DEBUG_SOURCE_API
+#define GL_DEBUG_SOURCE_API 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM 0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY 0x8249
+#define GL_DEBUG_SOURCE_APPLICATION 0x824A
+#define GL_DEBUG_SOURCE_OTHER 0x824B
+#endif
+#ifndef GL_DEBUG_TYPE_ERROR
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#define GL_DEBUG_TYPE_OTHER 0x8251
+#define GL_DEBUG_TYPE_MARKER 0x8268
+#define GL_DEBUG_TYPE_PUSH_GROUP 0x8269
+#define GL_DEBUG_TYPE_POP_GROUP 0x826A
+#endif
+#ifndef GL_DEBUG_SEVERITY_HIGH
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+namespace lgl
+{
+namespace ext
+{
+
+typedef void (APIENTRYP PFNLGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNLGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNLGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNLGLMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+typedef void (APIENTRYP PFNLGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP PFNLGLDEBUGMESSAGECONTROLPROC)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+
+// nullptr if not available
+extern PFNLGLGETPROGRAMBINARYPROC GetProgramBinary;
+extern PFNLGLPROGRAMBINARYPROC ProgramBinary;
+extern PFNLGLPROGRAMPARAMETERIPROC ProgramParameteri;
+extern PFNLGLMAXSHADERCOMPILERTHREADSPROC MaxShaderCompilerThreads;     // KHR or ARB variant
+extern PFNLGLDEBUGMESSAGECALLBACKPROC DebugMessageCallback;
+extern PFNLGLDEBUGMESSAGECONTROLPROC DebugMessageControl;
+
+/**
+ * Load optional OpenGL functions.
+ * Call this right after glad is loaded with the same loader function i.e. glfwGetProcAddress.
+ * lgl::App::Setup() already does this.
+ *
+ * \param load Function to get address of OpenGL function
+ */
+void Load(GLADloadproc load);
+
+/**
+ * Check whether OpenGL extension is supported by current context.
+ *
+ * \param extension Name of extension i.e. "GL_ARB_get_program_binary"
+ */
+bool IsSupported(const char* extension);
+
+/**
+ * Check whether current OpenGL version is at least major.minor
+ */
+bool IsVersionAtLeast(int major, int minor);
+
+/**
+ * Whether program binary can be retrieved and loaded back (GL_ARB_get_program_binary).
+ */
+bool HasProgramBinary();
+
+/**
+ * Whether driver compiles and links shaders on its own threads, and completion can be polled
+ * via GL_COMPLETION_STATUS_KHR without blocking (GL_KHR_parallel_shader_compile or
+ * GL_ARB_parallel_shader_compile).
+ */
+bool HasParallelShaderCompile();
+
+/**
+ * Whether DXT1 (BC1) and DXT5 (BC3) compressed textures can be uploaded (GL_EXT_texture_compression_s3tc).
+ */
+bool HasTextureCompressionS3TC();
+
+/**
+ * Whether driver can report errors and warnings through callback (GL_KHR_debug).
+ * It's most verbose on debug context, see lgl::AppConfigs::DebugContext.
+ */
+bool HasDebugOutput();
+
+}
+}
+
+#endif // _EXT_H_
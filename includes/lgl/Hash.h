@@ -0,0 +1,46 @@
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#include <cstdint>
+#include <cstddef>
+
+namespace lgl
+{
+namespace hash
+{
+
+/**
+ * 32-bit FNV-1a hash of null-terminated string.
+ * It's constexpr thus it can be used to compute hash of string literal at compile time,
+ * and it doesn't allocate any memory when used at run-time.
+ *
+ * \param str Null-terminated string to hash
+ * \param h Running hash value, leave it as default to start hashing from the beginning
+ * \return 32-bit hash value
+ */
+constexpr std::uint32_t Fnv1a(const char* str, std::uint32_t h = 2166136261u)
+{
+    return *str == '\0' ? h : Fnv1a(str + 1, (h ^ static_cast<std::uint8_t>(*str)) * 16777619u);
+}
+
+/**
+ * 64-bit FNV-1a hash of arbitrary bytes.
+ * Pass returned value as h to continue hashing more data as if they are concatenated.
+ *
+ * \param data Pointer to bytes to hash
+ * \param size Number of bytes
+ * \param h Running hash value, leave it as default to start hashing from the beginning
+ * \return 64-bit hash value
+ */
+inline std::uint64_t Fnv1a64(const void* data, std::size_t size, std::uint64_t h = 14695981039346656037ull)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i=0; i<size; ++i)
+        h = (h ^ bytes[i]) * 1099511628211ull;
+    return h;
+}
+
+}
+}
+
+#endif // _HASH_H_
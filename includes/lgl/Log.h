@@ -0,0 +1,216 @@
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// severity levels, messages below LGL_LOG_LEVEL are stripped at compile time
+#define LGL_LOG_LEVEL_DEBUG 0
+#define LGL_LOG_LEVEL_INFO 1
+#define LGL_LOG_LEVEL_WARN 2
+#define LGL_LOG_LEVEL_ERROR 3
+
+#ifndef LGL_LOG_LEVEL
+#ifndef LGL_NODEBUG
+#define LGL_LOG_LEVEL LGL_LOG_LEVEL_DEBUG
+#else
+#define LGL_LOG_LEVEL LGL_LOG_LEVEL_WARN
+#endif
+#endif
+
+// first argument is printf-style format, it must be string literal as it's formatted later on writer thread
+#if LGL_LOG_LEVEL <= LGL_LOG_LEVEL_DEBUG
+#define LGL_LOG_DEBUG(...) lgl::log::Write(lgl::log::SEVERITY_DEBUG, __VA_ARGS__)
+#else
+#define LGL_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LGL_LOG_LEVEL <= LGL_LOG_LEVEL_INFO
+#define LGL_LOG_INFO(...) lgl::log::Write(lgl::log::SEVERITY_INFO, __VA_ARGS__)
+#else
+#define LGL_LOG_INFO(...) ((void)0)
+#endif
+
+#if LGL_LOG_LEVEL <= LGL_LOG_LEVEL_WARN
+#define LGL_LOG_WARN(...) lgl::log::Write(lgl::log::SEVERITY_WARN, __VA_ARGS__)
+#else
+#define LGL_LOG_WARN(...) ((void)0)
+#endif
+
+#if LGL_LOG_LEVEL <= LGL_LOG_LEVEL_ERROR
+#define LGL_LOG_ERROR(...) lgl::log::Write(lgl::log::SEVERITY_ERROR, __VA_ARGS__)
+#else
+#define LGL_LOG_ERROR(...) ((void)0)
+#endif
+
+namespace lgl
+{
+
+/*
+====================
+Logger
+====================
+*/
+
+/**
+ * Thread-safe logger that does as little as possible on calling thread.
+ *
+ * Write() only copies format pointer, arguments (contents of strings included) and timestamp into
+ * a lock-free ring owned by calling thread, no lock nor allocation after its first message. A
+ * background writer thread formats them in printf-style and writes them to stderr in batches.
+ * Message is dropped and counted if ring of its thread is full.
+ *
+ * The same format repeated more than 10 times within a second is suppressed for the rest of that
+ * second, then its number of suppressed repeats is printed. Errors are never suppressed.
+ *
+ * Writer thread starts on the first message, and stops when process exits after printing what's left.
+ * Don't log from threads that outlive main().
+ */
+namespace log
+{
+
+enum Severity
+{
+    SEVERITY_DEBUG = LGL_LOG_LEVEL_DEBUG,
+    SEVERITY_INFO = LGL_LOG_LEVEL_INFO,
+    SEVERITY_WARN = LGL_LOG_LEVEL_WARN,
+    SEVERITY_ERROR = LGL_LOG_LEVEL_ERROR
+};
+
+/**
+ * Counters of logger, see GetStats().
+ */
+struct LogStats
+{
+    std::uint64_t written;      // messages printed
+    std::uint64_t dropped;      // messages lost as ring of their thread was full
+    std::uint64_t suppressed;   // repeats not printed due to rate limit
+};
+
+/**
+ * Argument of message as it's stored until writer formats it.
+ */
+struct Arg
+{
+    enum Type : std::uint8_t
+    {
+        INT,
+        UINT,
+        DOUBLE,
+        POINTER,
+        STRING
+    };
+
+    Type type;
+    union
+    {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+        std::size_t length;     // length of STRING
+    };
+    const char* str;            // STRING only, copied when message is written
+};
+
+inline void Encode(Arg& arg, const char* value)
+{
+    arg.type = Arg::STRING;
+    arg.str = value != nullptr ? value : "(null)";
+    arg.length = std::strlen(arg.str);
+}
+
+inline void Encode(Arg& arg, char* value)
+{
+    Encode(arg, static_cast<const char*>(value));
+}
+
+inline void Encode(Arg& arg, const std::string& value)
+{
+    arg.type = Arg::STRING;
+    arg.str = value.c_str();
+    arg.length = value.size();
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type Encode(Arg& arg, T value)
+{
+    arg.type = Arg::INT;
+    arg.i = value;
+}
+
+template <typename T>
+inline typename std::enable_if<(std::is_integral<T>::value && !std::is_signed<T>::value) || std::is_enum<T>::value>::type Encode(Arg& arg, T value)
+{
+    arg.type = Arg::UINT;
+    arg.u = static_cast<unsigned long long>(value);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type Encode(Arg& arg, T value)
+{
+    arg.type = Arg::DOUBLE;
+    arg.d = value;
+}
+
+template <typename T>
+inline void Encode(Arg& arg, const T* value)
+{
+    arg.type = Arg::POINTER;
+    arg.p = value;
+}
+
+inline void EncodeAll(Arg*)
+{
+}
+
+template <typename T, typename... Rest>
+inline void EncodeAll(Arg* args, const T& first, const Rest&... rest)
+{
+    Encode(*args, first);
+    EncodeAll(args + 1, rest...);
+}
+
+/**
+ * Queue message to be written, prefer LGL_LOG_* macros which strip it at compile time.
+ *
+ * \param severity Severity of message
+ * \param fmt printf-style format, must stay valid until process exits i.e. string literal
+ * \param args Arguments of format, strings are copied
+ */
+void Submit(Severity severity, const char* fmt, const Arg* args, unsigned int numArgs);
+
+template <typename... Args>
+inline void Write(Severity severity, const char* fmt, const Args&... args)
+{
+    static_assert(sizeof...(Args) <= 16, "too many arguments for log message");
+    Arg encoded[sizeof...(Args)];
+    EncodeAll(encoded, args...);
+    Submit(severity, fmt, encoded, sizeof...(Args));
+}
+
+inline void Write(Severity severity, const char* fmt)
+{
+    Submit(severity, fmt, nullptr, 0);
+}
+
+/**
+ * Block until every message queued so far by any thread is written, i.e. before terminating.
+ */
+void Flush();
+
+/**
+ * Discard messages written from now on by any thread, errors included, until unmuted. Messages
+ * queued before are still written, i.e. to silence expected errors of a test.
+ */
+void SetMuted(bool muted);
+
+LogStats GetStats();
+
+}
+}
+
+#endif // _LOG_H_
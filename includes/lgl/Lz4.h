@@ -0,0 +1,49 @@
+#ifndef _LZ4_H_
+#define _LZ4_H_
+
+#include <cstddef>
+
+/**
+ * LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md) without frame,
+ * used to compress entries of packed archive (see lgl::vfs). Output of CompressBlock() can be
+ * decompressed by reference LZ4 implementation, and vice versa.
+ */
+
+namespace lgl
+{
+namespace lz4
+{
+
+/**
+ * Maximum size of compressed block of input size, the worst case when input is incompressible.
+ */
+inline std::size_t GetCompressBound(std::size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+/**
+ * Compress input with greedy matching, it favours decompression speed over ratio.
+ *
+ * \param src Input bytes
+ * \param srcSize Number of input bytes
+ * \param dst Output buffer of at least GetCompressBound(srcSize) bytes
+ * \return Number of bytes written into dst
+ */
+std::size_t CompressBlock(const void* src, std::size_t srcSize, void* dst);
+
+/**
+ * Decompress block, it never reads nor writes out of bounds of either buffer even if input is corrupted.
+ *
+ * \param src Compressed block
+ * \param srcSize Size of compressed block
+ * \param dst Output buffer
+ * \param dstSize Exact size of decompressed data
+ * \return Return 0 for success, otherwise LGL_FAIL if block is corrupted or doesn't decompress to dstSize bytes.
+ */
+int DecompressBlock(const void* src, std::size_t srcSize, void* dst, std::size_t dstSize);
+
+}
+}
+
+#endif // _LZ4_H_
@@ -0,0 +1,60 @@
+#ifndef _MIPMAP_H_
+#define _MIPMAP_H_
+
+#include <cstddef>
+
+/**
+ * Generate mipmaps on CPU, i.e. on worker threads before upload instead of glGenerateMipmap() which
+ * is slow on software OpenGL (llvmpipe), and filters sRGB images as if they're linear.
+ *
+ * Each level is half of the previous one with 2x2 box filter, rounded down but at least 1 as OpenGL
+ * expects. Color channels of sRGB images are converted to linear before averaging, then back.
+ * Alpha (4th channel, or 2nd of 2-channel images) is always averaged as it is.
+ *
+ * 4-channel images are filtered with SSE2 when available, others with SSE2 vertically then scalar
+ * horizontally. Define LGL_NO_SIMD to force scalar code i.e. to compare.
+ */
+
+namespace lgl
+{
+namespace mipmap
+{
+
+/**
+ * Number of levels of full mipmap chain down to 1x1, including base level.
+ */
+int GetNumLevels(int width, int height);
+
+/**
+ * Size in bytes of full mipmap chain of tightly packed 8-bit pixels, including base level.
+ */
+std::size_t GetChainSize(int width, int height, int nrChannels);
+
+/**
+ * Downsample image to the next level.
+ *
+ * \param src Tightly packed 8-bit pixels
+ * \param width Width of src
+ * \param height Height of src
+ * \param nrChannels Number of channels, 1 to 4
+ * \param isSRGB Whether color channels are sRGB-encoded
+ * \param dst Output of max(1, width/2) x max(1, height/2) pixels, it must not overlap src
+ */
+void Downsample(const unsigned char* src, int width, int height, int nrChannels, bool isSRGB, unsigned char* dst);
+
+/**
+ * Generate all levels after base level in place.
+ *
+ * \param chain Buffer of GetChainSize() bytes with base level at the beginning, levels are written right after
+ *              each other without padding.
+ * \param width Width of base level
+ * \param height Height of base level
+ * \param nrChannels Number of channels, 1 to 4
+ * \param isSRGB Whether color channels are sRGB-encoded
+ */
+void GenerateChain(unsigned char* chain, int width, int height, int nrChannels, bool isSRGB);
+
+}
+}
+
+#endif // _MIPMAP_H_
@@ -0,0 +1,62 @@
+#ifndef _PACK_FILE_H_
+#define _PACK_FILE_H_
+
+#include <cstdint>
+
+namespace lgl
+{
+namespace pack
+{
+
+/*
+====================
+Packed archive
+====================
+*/
+
+/**
+ * Layout of packed archive (.lgp) written by src/AssetPacker, and mounted by lgl::vfs::MountArchive().
+ * Archive is memory-mapped as a whole, then entries are looked up by name from its index.
+ *
+ * [Header][Entry x numEntries][string table][padding][blob 0][padding][blob 1]...
+ *
+ * Names in string table are relative paths with '/' as separator, not null-terminated.
+ * All fields are little-endian. Each blob starts at offset aligned to kDataAlignment.
+ */
+
+const char kMagic[4] = { 'L', 'G', 'L', 'P' };
+const std::uint32_t kVersion = 1;
+const std::uint32_t kDataAlignment = 16;
+
+enum Compression
+{
+    COMPRESSION_NONE = 0,   // blob is content as it is
+    COMPRESSION_LZ4 = 1     // blob is a single LZ4 block, see lgl/Lz4.h
+};
+
+struct Header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t numEntries;
+    std::uint32_t stringTableSize;  // in bytes, right after entry table
+};
+
+struct Entry
+{
+    std::uint64_t offset;       // of blob from the beginning of file
+    std::uint64_t storedSize;   // size of blob in bytes
+    std::uint64_t size;         // size of content after decompressed
+    std::uint32_t nameOffset;   // from the beginning of string table
+    std::uint32_t nameLength;
+    std::uint32_t compression;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 16, "Header must have no padding as it's written to file as it is");
+static_assert(sizeof(Entry) == 40, "Entry must have no padding as it's written to file as it is");
+
+}
+}
+
+#endif // _PACK_FILE_H_
@@ -0,0 +1,88 @@
+#ifndef _PAGED_TEXTURE_H_
+#define _PAGED_TEXTURE_H_
+
+#include <cstdint>
+
+namespace lgl
+{
+namespace paged
+{
+
+/*
+====================
+Paged texture file
+====================
+*/
+
+/**
+ * Layout of virtual texture page file (.lgv) written by src/TextureBaker with -v, and streamed by
+ * lgl::VirtualTexture. Image is split into square pages of every mipmap level, so any page can be
+ * read on its own at fixed offset.
+ *
+ * [FileHeader][padding up to kDataOffset][pages of level 0][pages of level 1]...
+ *
+ * Each page is RGBA8 of (pageSize + 2 * border) texels per side, its content is surrounded by border
+ * of neighbouring texels (or repeated edge at image edge) so it can be filtered bilinearly on its own.
+ * Pages of each level are in row-major order, starting from bottom-left as image is already flipped
+ * vertically the same as lgl::util::LoadTexture() does.
+ *
+ * Level 0 is padded with repeated edge up to pagesX x pagesY pages, both are multiples of
+ * 2^(numLevels - 1) so each level has exactly half pages of the previous one. The coarsest level
+ * has at least one page on its shorter side.
+ *
+ * All fields are little-endian.
+ */
+
+const char kMagic[4] = { 'L', 'G', 'L', 'V' };
+const std::uint32_t kVersion = 1;
+const std::uint32_t kDataOffset = 64;
+const std::uint32_t kMaxPages = 256;    // per side of level 0, page coordinates are 8-bit
+
+struct FileHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width;        // of image before padding
+    std::uint32_t height;
+    std::uint32_t pageSize;     // content of page in texels per side, excluding border
+    std::uint32_t border;       // in texels
+    std::uint32_t numLevels;
+    std::uint32_t pagesX;       // number of pages of level 0
+    std::uint32_t pagesY;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 40, "FileHeader must have no padding as it's written to file as it is");
+
+/**
+ * Size in bytes of a page including its border.
+ */
+inline std::uint64_t GetPageBytes(const FileHeader& header)
+{
+    const std::uint64_t side = header.pageSize + 2 * header.border;
+    return side * side * 4;
+}
+
+/**
+ * Index of the first page of level, which is also number of pages of all finer levels.
+ */
+inline std::uint32_t GetFirstPage(const FileHeader& header, std::uint32_t level)
+{
+    std::uint32_t first = 0;
+    for (std::uint32_t i=0; i<level; ++i)
+        first += (header.pagesX >> i) * (header.pagesY >> i);
+    return first;
+}
+
+/**
+ * Number of pages of all levels.
+ */
+inline std::uint32_t GetNumPages(const FileHeader& header)
+{
+    return GetFirstPage(header, header.numLevels);
+}
+
+}
+}
+
+#endif // _PAGED_TEXTURE_H_
@@ -0,0 +1,105 @@
+#ifndef _PIXEL_BUFFER_RING_H_
+#define _PIXEL_BUFFER_RING_H_
+
+#include "Wrapped_GL.h"
+#include <cstddef>
+#include <vector>
+
+namespace lgl
+{
+
+/*
+====================
+Pixel buffer ring
+====================
+*/
+
+/**
+ * Fixed ring of pixel buffer objects (GL_PIXEL_UNPACK_BUFFER) reused for staging texture uploads.
+ *
+ * Each slot goes through Acquire() -> Map() -> fill mapped memory (from any thread) -> Unmap() ->
+ * upload texture from it while it's bound -> Release(). Release() puts a fence after the upload,
+ * and the slot is only acquired again once GPU has passed such fence, so mapping it again never
+ * has to wait for GPU (GL_MAP_UNSYNCHRONIZED_BIT).
+ *
+ * All functions are meant to be called only from thread that owns OpenGL context.
+ */
+class PixelBufferRing
+{
+public:
+    PixelBufferRing();
+
+    /**
+     * Create buffer objects.
+     *
+     * \param numBuffers Number of buffers in the ring
+     * \param initialSize Initial size in bytes of each buffer, it grows when acquired for larger size
+     * \return Return 0 for success, otherwise LGL_FAIL.
+     */
+    int Create(unsigned int numBuffers, std::size_t initialSize);
+
+    /**
+     * Delete all buffer objects. Mapped buffers are unmapped.
+     */
+    void Destroy();
+
+    /**
+     * Acquire free slot with at least input size. It doesn't block.
+     *
+     * \return Index of slot, or LGL_FAIL if all slots are in use or GPU hasn't finished with them yet.
+     */
+    int Acquire(std::size_t size);
+
+    /**
+     * Size in bytes of slot, it's at least the size it's acquired for.
+     */
+    inline std::size_t GetCapacity(int slot) const
+    {
+        return slots[slot].capacity;
+    }
+
+    /**
+     * Map acquired slot for writing. Returned pointer can be written from any thread until Unmap().
+     */
+    void* Map(int slot);
+
+    /**
+     * Unmap slot, then bind it to GL_PIXEL_UNPACK_BUFFER so texture can be uploaded from it
+     * with nullptr as data.
+     *
+     * \return Return 0 for success, otherwise LGL_FAIL if content of buffer is lost while it's mapped
+     *         (i.e. screen mode change), in which case slot is released.
+     */
+    int UnmapAndBind(int slot);
+
+    /**
+     * Put fence after upload commands from slot, unbind GL_PIXEL_UNPACK_BUFFER, and release slot.
+     */
+    void Release(int slot);
+
+    /**
+     * Number of times Acquire() failed while GPU was still reading from a released slot, which means
+     * uploads are issued faster than GPU consumes them.
+     */
+    inline unsigned int GetNumStalls() const
+    {
+        return numStalls;
+    }
+
+private:
+    struct Slot
+    {
+        GLuint buffer;
+        std::size_t capacity;
+        GLsync fence;           // upload from this slot, nullptr if there's none in flight
+        bool isAcquired;
+    };
+
+    std::vector<Slot> slots;
+    unsigned int next;          // next slot to try acquiring, slots are used round-robin
+    unsigned int numStalls;
+};
+
+}
+
+#endif // _PIXEL_BUFFER_RING_H_
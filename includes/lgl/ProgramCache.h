@@ -0,0 +1,94 @@
+#ifndef _PROGRAM_CACHE_H_
+#define _PROGRAM_CACHE_H_
+
+#include "Wrapped_GL.h"
+#include <cstdint>
+#include <string>
+
+namespace lgl
+{
+
+/**
+ * Counters and timing of building shader programs, see ProgramCache::GetStats().
+ */
+struct ProgramCacheStats
+{
+    unsigned int hits;          // program loaded from cached binary
+    unsigned int misses;        // program compiled from source
+    unsigned int rejected;      // cached binary exists but driver rejected it, then compiled from source
+    double hitSeconds;          // total time spent loading programs from cached binary
+    double missSeconds;         // total time spent compiling and linking programs from source
+};
+
+/*
+====================
+Program binary cache
+====================
+*/
+
+/**
+ * On-disk cache of linked shader program binary (GL_ARB_get_program_binary).
+ * lgl::Shader uses this automatically when it's enabled via SetDirectory(), and falls back to
+ * compile from source whenever there is no cached binary, or driver rejects it i.e. driver is updated.
+ *
+ * Cached binary is keyed by hash of shader sources plus GL_VENDOR, GL_RENDERER and GL_VERSION, so
+ * it won't be loaded on different driver.
+ *
+ * It's disabled by default, and it does nothing if driver doesn't support any program binary format.
+ * Not thread-safe, it's meant to be used only from thread that owns OpenGL context.
+ */
+class ProgramCache
+{
+public:
+    /**
+     * Set directory to store cached program binaries into, it will be created if not exist.
+     * Call this after OpenGL context is created, and lgl::ext::Load() is called.
+     *
+     * \param dir Directory path, nullptr to disable caching
+     */
+    static void SetDirectory(const char* dir);
+
+    /**
+     * Whether caching is enabled and supported by driver.
+     */
+    static bool IsEnabled();
+
+    /**
+     * Create program from cached binary of input shader sources.
+     *
+     * \return Linked program object if cached binary exists and is accepted by driver, otherwise 0.
+     */
+    static GLuint Load(const char* vertexShaderStr, const char* fragmentShaderStr);
+
+    /**
+     * Mark program to be retrievable as binary, call this before linking the program.
+     */
+    static void PrepareForLink(GLuint program);
+
+    /**
+     * Save binary of linked program as cache for input shader sources.
+     */
+    static void Save(GLuint program, const char* vertexShaderStr, const char* fragmentShaderStr);
+
+    static const ProgramCacheStats& GetStats();
+
+    /**
+     * Add time spent building a program to the stats.
+     *
+     * \param fromCache Whether the program was loaded from cached binary
+     * \param seconds Time spent
+     */
+    static void RecordBuildTime(bool fromCache, double seconds);
+
+private:
+    static std::string directory;
+    static std::uint64_t driverHash;
+    static ProgramCacheStats stats;
+
+    static std::uint64_t ComputeKey(const char* vertexShaderStr, const char* fragmentShaderStr);
+    static std::string GetFilePath(std::uint64_t key);
+};
+
+}
+
+#endif // _PROGRAM_CACHE_H_
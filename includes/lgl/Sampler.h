@@ -0,0 +1,90 @@
+#ifndef _SAMPLER_H_
+#define _SAMPLER_H_
+
+#include "Wrapped_GL.h"
+#include <vector>
+
+namespace lgl
+{
+
+/**
+ * Texture wrapping and filtering, i.e. parameters of shared sampler object, or part of key of
+ * cached texture (see lgl::TextureCache).
+ * Default is the same as lgl::util::LoadTexture() sets.
+ */
+struct TextureSampling
+{
+    GLint wrapS;
+    GLint wrapT;
+    GLint minFilter;
+    GLint magFilter;
+
+    TextureSampling():
+        wrapS(GL_REPEAT),
+        wrapT(GL_REPEAT),
+        minFilter(GL_LINEAR),
+        magFilter(GL_LINEAR)
+    {
+    }
+
+    TextureSampling(GLint wrapS, GLint wrapT, GLint minFilter, GLint magFilter):
+        wrapS(wrapS),
+        wrapT(wrapT),
+        minFilter(minFilter),
+        magFilter(magFilter)
+    {
+    }
+
+    inline bool operator==(const TextureSampling& other) const
+    {
+        return wrapS == other.wrapS && wrapT == other.wrapT && minFilter == other.minFilter && magFilter == other.magFilter;
+    }
+};
+
+/*
+====================
+Sampler
+====================
+*/
+
+/**
+ * Process-wide sampler objects shared by their parameters.
+ * Sampler bound to texture unit overrides wrapping and filtering of whichever texture is bound
+ * there, so the same texture can be sampled differently without setting its parameters nor
+ * duplicating it. Bind it via lgl::TextureUnits::BindSampler().
+ *
+ * Not thread-safe, it's meant to be used only from thread that owns OpenGL context.
+ */
+class Sampler
+{
+public:
+    /**
+     * Get shared sampler object of input parameters, create it if there is none yet.
+     * It's owned by this cache, don't delete it.
+     *
+     * \param sampling Wrapping and filtering
+     * \return Sampler object
+     */
+    static GLuint Get(const TextureSampling& sampling);
+
+    /**
+     * Delete all sampler objects. Call this before OpenGL context is destroyed.
+     */
+    static void Clear();
+
+    static unsigned int GetNumSamplers();
+
+private:
+    struct Entry
+    {
+        TextureSampling sampling;
+        GLuint sampler;
+    };
+
+    // only a handful of distinct parameter sets exist, linear search beats hashing
+    static std::vector<Entry> entries;
+};
+
+}
+
+#endif // _SAMPLER_H_
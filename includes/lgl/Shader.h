@@ -4,8 +4,13 @@
 #include "Bits.h"
 #include "Wrapped_GL.h"
 #include "Error.h"
-#include <unordered_map>
-#include <utility>
+#include "Hash.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 
 // as it's a single translation unit, then we still need to define
 // LGL_EXTERNAL_GLM_INCLUDE here
@@ -15,6 +20,36 @@
 namespace lgl
 {
 
+/**
+ * Information of active uniform variable of shader program, as reflected from OpenGL right after
+ * the program is linked.
+ */
+struct UniformInfo
+{
+    std::uint32_t hash;     // lgl::hash::Fnv1a() of name
+    GLint location;
+    GLenum type;            // i.e. GL_FLOAT_MAT4, GL_FLOAT_VEC3, GL_SAMPLER_2D
+                            // GL_NONE for alias looked up lazily i.e. "lights[2]", which is not reflected
+    GLint size;             // number of elements for array, otherwise 1. 0 for alias.
+    std::string name;       // array has its "[0]" suffix stripped
+};
+
+/**
+ * Counters of uniform uploads of a shader.
+ */
+struct UniformUploadStats
+{
+    unsigned long long issued;      // value is changed, glUniform*() is called
+    unsigned long long skipped;     // value is the same as the last one, no call to OpenGL
+};
+
+/**
+ * Feature defines to specialise shader with, i.e. { "INSTANCED", "NUM_LIGHTS 4" }.
+ * Each one is either a name, or a name followed by its value separated by space or '='.
+ * Order doesn't matter, see Shader::InjectDefines().
+ */
+typedef std::vector<std::string> ShaderDefines;
+
 class Shader
 {
 public:
@@ -24,114 +59,398 @@ public:
      * Build shader program for this shader.
      * \param vertex shader code string as null-terminated string.
      * \param fragment shader code string as null-terminated string.
+     * \param defines Feature defines injected into both sources, see InjectDefines().
      * \return Return 0 for success, otherwise error occurs.
+     *
+     * Building again destroys program of previous build. If building fails, all OpenGL objects
+     * created during the build are deleted, and errors are printed with line numbers of input
+     * sources (before defines are injected).
      */
-    int BuildFromSrc(const char* vertexShaderStr, const char* fragmentShaderStr);
+    int BuildFromSrc(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines = ShaderDefines());
 
     /**
      * Build shader program for this shader.
+     * \param defines Feature defines injected into both sources, see InjectDefines().
      * \return Return 0 for success, otherwise error occurs.
      */
-    int Build(const char* vertexPath, const char* fragmentPath);
+    int Build(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines = ShaderDefines());
+
+    /**
+     * Start building shader program without waiting for compilation and linking to finish.
+     * With GL_KHR_parallel_shader_compile, driver compiles on its own threads so application can
+     * do other work i.e. load textures in the meantime. Start all builds up front, then call
+     * FinishBuild() of each shader once it's needed.
+     *
+     * Without such extension, driver may still defer compilation until its status is queried
+     * in FinishBuild().
+     *
+     * \param vertexShaderStr Vertex shader code as null-terminated string
+     * \param fragmentShaderStr Fragment shader code as null-terminated string
+     * \return Return 0 if build is started, otherwise error occurs.
+     */
+    int BuildFromSrcAsync(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines = ShaderDefines());
+
+    /**
+     * Same as BuildFromSrcAsync() but read shader sources from files.
+     * \return Return 0 if build is started, otherwise error occurs.
+     */
+    int BuildAsync(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines = ShaderDefines());
+
+    /**
+     * Insert "#define" line for each of defines right after "#version" line of source, or at the
+     * beginning if there is no such line. Defines are sorted first, so the same set of defines
+     * always results in the same source regardless of their order, thus the same cache key for
+     * lgl::ProgramCache and lgl::ShaderRegistry.
+     *
+     * \param src Shader code as null-terminated string
+     * \param defines Feature defines, "NAME=VALUE" is written as "#define NAME VALUE"
+     * \return Shader code with defines injected
+     */
+    static std::string InjectDefines(const char* src, const ShaderDefines& defines);
+
+    /**
+     * Whether build started by BuildFromSrcAsync() has completed, so FinishBuild() won't block.
+     * It's always true if there is no pending build, or driver doesn't support
+     * GL_KHR_parallel_shader_compile.
+     */
+    bool IsReady() const;
+
+    /**
+     * Wait for build started by BuildFromSrcAsync() to complete, then check its result.
+     * Required: call this before using this shader. It does nothing if there is no pending build.
+     *
+     * \return Return 0 for success, otherwise error occurs.
+     */
+    int FinishBuild();
+
+    inline bool IsBuildPending() const
+    {
+        return pending.vertexShader != 0;
+    }
+
+    /**
+     * Whether this shader has linked program, false if it's not built yet, its build is pending, or failed.
+     */
+    inline bool IsBuilt() const
+    {
+        return program != 0 && !IsBuildPending();
+    }
+
+    /**
+     * Replace program of this shader with the one of successfully built input shader, i.e. for
+     * hot-reloading. Values set through this shader are carried over to new program for uniform
+     * variables with the same name and type, then old program is destroyed and input shader is
+     * left empty.
+     *
+     * Uniform locations might be different on new program, so resolve them again after this.
+     *
+     * \param built Shader which has been built successfully, and its build is not pending
+     */
+    void ReplaceProgram(Shader& built);
 
     /**
      * Tell OpenGL to use this shader.
+     * It's skipped if this shader is already in use.
      */
     void Use() const;
 
     /**
-     * Destory states and clean up memory used by this shader.
-     * Only call this after shader has been build successfully, otherwise undefine behavior as program object number can be anything.
+     * Forget which program is in use, so next Use() of any shader will call glUseProgram().
+     * Call this after calling glUseProgram() directly, not through Use().
+     */
+    static void InvalidateBoundProgram();
+
+    /**
+     * Destory states and clean up memory used by this shader, including pending build if any.
+     * It's safe to call even if shader hasn't been built, or building has failed.
      */
     void Destroy();
 
-    /** Uniform setting functions **/
+    /**
+     * Uniform setting functions
+     *
+     * Required: this shader is in use, see Use().
+     *
+     * Last value set to each reflected uniform variable is kept as shadow copy on CPU side,
+     * setting the same value again is skipped without calling OpenGL. See GetUniformUploadStats().
+     */
     inline void SetUniform(GLint location, GLint value) const
     {
+        if (IsUniformUnchanged(location, &value, sizeof(value)))
+            return;
         glUniform1i(location, value);
         LGL_AnyGLErrorMsgOnly
     }
 
     inline void SetUniform(GLint location, GLfloat value) const
     {
+        if (IsUniformUnchanged(location, &value, sizeof(value)))
+            return;
         glUniform1f(location, value);
         LGL_AnyGLErrorMsgOnly
     }
 
+    inline void SetUniform(GLint location, const glm::vec2& value) const
+    {
+        if (IsUniformUnchanged(location, glm::value_ptr(value), sizeof(value)))
+            return;
+        glUniform2fv(location, 1, glm::value_ptr(value));
+        LGL_AnyGLErrorMsgOnly
+    }
+
+    inline void SetUniform(GLint location, const glm::vec3& value) const
+    {
+        if (IsUniformUnchanged(location, glm::value_ptr(value), sizeof(value)))
+            return;
+        glUniform3fv(location, 1, glm::value_ptr(value));
+        LGL_AnyGLErrorMsgOnly
+    }
+
+    inline void SetUniform(GLint location, const glm::vec4& value) const
+    {
+        if (IsUniformUnchanged(location, glm::value_ptr(value), sizeof(value)))
+            return;
+        glUniform4fv(location, 1, glm::value_ptr(value));
+        LGL_AnyGLErrorMsgOnly
+    }
+
+    inline void SetUniform(GLint location, const glm::mat4& value) const
+    {
+        if (IsUniformUnchanged(location, glm::value_ptr(value), sizeof(value)))
+            return;
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+        LGL_AnyGLErrorMsgOnly
+    }
+
     /**
      * Set uniform value from uniform variable name 'vname'.
-     * It will save vname into hashmap if not exist yet for later more efficient updating
-     * value into the same uniform variable again.
      */
     inline void SetUniform(const char *vname, GLint value)
     {
-        // try to get such vname's location from hashmap first
         const auto loc = GetUniformLocation(vname);
         if (loc != LGL_FAIL)
-        {
-            glUniform1i(loc, value);
-            LGL_AnyGLErrorMsgOnly
-        }
+            SetUniform(loc, value);
     }
 
     /**
      * Set uniform value from uniform variable name vname.
-     * It will save vname into hashmap if not exist yet for later more efficient updating
-     * value into the same uniform variable again.
      */
     inline void SetUniform(const char *vname, GLfloat value)
     {
-        // try to get such vname's location from hashmap first
         const auto loc = GetUniformLocation(vname);
         if (loc != LGL_FAIL)
-        {
-            glUniform1f(loc, value);
-            LGL_AnyGLErrorMsgOnly
-        }
+            SetUniform(loc, value);
     }
 
     /**
-     * Get cached location values from input vname for uniform variable.
-     * If not found inside the cache, it will save it, then attempt to get OpenGL location to return it.
+     * Associate uniform block of this shader with binding point, so it reads values from
+     * uniform buffer object bound there i.e. lgl::UniformBlock.
+     *
+     * \param blockName Name of uniform block as declared in GLSL
+     * \param bindingPoint Binding point, see lgl::UniformBlock::GetBindingPoint()
+     * \return Return 0 for success, otherwise return LGL_FAIL if there is no such block.
+     */
+    int BindUniformBlock(const char* blockName, GLuint bindingPoint);
+
+    /**
+     * Get number of uniform uploads issued to OpenGL, and skipped as value is unchanged
+     * since last reset.
+     */
+    inline const UniformUploadStats& GetUniformUploadStats() const
+    {
+        return uploadStats;
+    }
+
+    inline void ResetUniformUploadStats()
+    {
+        uploadStats.issued = 0;
+        uploadStats.skipped = 0;
+    }
+
+    /**
+     * Forget all shadow copies of uniform values, so next setting of any value will be uploaded.
+     * Call this after setting uniform value via glUniform*() directly, not through this shader.
+     */
+    void InvalidateUniformShadow();
+
+    /**
+     * Get location of uniform variable from input vname.
+     * All active uniform variables are known right after the program is linked, so this only
+     * searches (no memory allocation) through such table. Names which are not part of the table
+     * i.e. individual array element like "lights[2]" are queried from OpenGL once then added into the table.
      * Returns LGL_FAIL if there is no such location from input vname, otherwise return its location.
+     *
+     * For hot path, prefer to call this once then keep returned location to set value via
+     * SetUniform(GLint, ...).
      */
     inline GLint GetUniformLocation(const char *vname)
     {
-        const auto e = vnamesHashmap.find(vname);
-        if (e != vnamesHashmap.end())
+        return GetUniformLocation(lgl::hash::Fnv1a(vname), vname);
+    }
+
+    /**
+     * Same as GetUniformLocation(const char*) but with pre-computed hash of vname.
+     * Use with lgl::hash::Fnv1a() on string literal to compute such hash at compile time.
+     *
+     * \param hash Hash of vname computed by lgl::hash::Fnv1a()
+     * \param vname Uniform variable name
+     */
+    inline GLint GetUniformLocation(std::uint32_t hash, const char *vname)
+    {
+        const int index = FindUniform(hash, vname);
+        if (index != LGL_FAIL)
         {
             // FOUND!
-            return e->second;
-        }
-        else
-        {
-            // NOT FOUND!
-            // try finding via opengl function first
-            GLint location = glGetUniformLocation(program, vname);
-            if (location == -1)
-            {
-                // NOT FOUND
-#ifndef LGL_NODEBUG
-                lgl::error::ErrorWarn("Cannot find uniform variable location for %s of shader %u", vname, program);
-#endif
-                return LGL_FAIL;
-            }
-            else
-            {
-                // save into hashmap
-                vnamesHashmap.emplace(std::make_pair(vname, location));
-                return location;
-            }
+            return uniforms[index].location;
         }
+        return LookupUniformLocation(hash, vname);
+    }
+
+    /**
+     * Get reflected information of uniform variable at input location.
+     * This is O(1) operation.
+     *
+     * \return Pointer to information of uniform variable, or nullptr if there is no active uniform at such location.
+     */
+    inline const UniformInfo* GetUniformInfo(GLint location) const
+    {
+        if (location < 0 || location >= static_cast<GLint>(locationIndices.size()) || locationIndices[location] == LGL_FAIL)
+            return nullptr;
+        return &uniforms[locationIndices[location]];
+    }
+
+    /**
+     * Get all active uniform variables of this shader sorted by their hash.
+     */
+    inline const std::vector<UniformInfo>& GetUniforms() const
+    {
+        return uniforms;
     }
 
 private:
     GLuint program;
 
-    // hashmap to store input variable names mapping to its computed location
-    // for fast execution and no need to call glGetUniformLocation() everytime
-    // users need to update its value
-    std::unordered_map<std::string, GLint> vnamesHashmap;
+    // build started by BuildFromSrcAsync(), until FinishBuild() is called
+    struct PendingBuild
+    {
+        GLuint vertexShader;            // 0 if there is no pending build
+        GLuint fragmentShader;
+        std::string vertexLabel;        // file path, or "vertex shader" if built from source
+        std::string fragmentLabel;
+        unsigned int numInjectedLines;  // number of defines injected, to map line numbers of errors back
+        std::string vertexShaderStr;    // kept only to save into ProgramCache
+        std::string fragmentShaderStr;
+        std::chrono::steady_clock::time_point startTime;
+    };
+    PendingBuild pending;
+
+    // program currently in use as set via Use()
+    static GLuint boundProgram;
+
+    // table of active uniform variables enumerated after linking, sorted by hash.
+    // Hashes are kept separately in its own flat array so binary search only touches
+    // tightly packed keys.
+    std::vector<std::uint32_t> uniformHashes;
+    std::vector<UniformInfo> uniforms;
+
+    // index into uniforms for each location, LGL_FAIL for location without active uniform
+    std::vector<int> locationIndices;
+
+    // hashes of names which are not found, to warn only once then skip querying OpenGL again
+    std::vector<std::uint32_t> missedHashes;
+
+    // shadow copy of the last uploaded value of each reflected uniform, indexed by location.
+    // Only first element is shadowed for array as setters upload a single element.
+    struct ShadowSlot
+    {
+        unsigned int offset;    // into shadowValues
+        unsigned int size;      // in bytes, 0 if not shadowed
+        bool valid;             // whether there is a value uploaded through this shader yet
+    };
+    mutable std::vector<ShadowSlot> shadowSlots;
+    mutable std::vector<unsigned char> shadowValues;
+    mutable UniformUploadStats uploadStats;
+
+    /**
+     * Allocate shadow slots for all reflected uniforms.
+     */
+    void SetupUniformShadow();
+
+    /**
+     * Check value against shadow copy at location, then update shadow copy if it is changed.
+     * Return true if value is the same as the last uploaded one thus uploading can be skipped.
+     */
+    inline bool IsUniformUnchanged(GLint location, const void* value, unsigned int size) const
+    {
+        if (location < 0 || location >= static_cast<GLint>(shadowSlots.size()) || shadowSlots[location].size != size)
+        {
+            // not shadowed, always upload
+            ++uploadStats.issued;
+            return false;
+        }
+
+        ShadowSlot& slot = shadowSlots[location];
+        unsigned char* shadow = shadowValues.data() + slot.offset;
+        if (slot.valid && std::memcmp(shadow, value, size) == 0)
+        {
+            ++uploadStats.skipped;
+            return true;
+        }
+
+        std::memcpy(shadow, value, size);
+        slot.valid = true;
+        ++uploadStats.issued;
+        return false;
+    }
+
+    /**
+     * Start build with defines injected, see BuildFromSrcAsync().
+     * Labels are used to identify each shader in error messages.
+     */
+    int StartBuild(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines, const char* vertexLabel, const char* fragmentLabel);
+
+    /**
+     * Read vertex and fragment shader sources from files.
+     * Return 0 for success, otherwise -1 if either file cannot be read.
+     */
+    static int ReadSources(const char* vertexPath, const char* fragmentPath, std::string& vsCode, std::string& fsCode);
+
+    /**
+     * Enumerate all active uniform variables of linked program into the table.
+     */
+    void ReflectUniforms();
+
+    /**
+     * Insert uniform variable into the table keeping it sorted.
+     */
+    void AddUniform(const UniformInfo& info);
+
+    /**
+     * Map each location to index into the table of uniform variable which owns it.
+     */
+    void RebuildLocationIndices();
+
+    /**
+     * Query OpenGL for location of vname which is not in the table yet, add it into the table
+     * if found.
+     */
+    GLint LookupUniformLocation(std::uint32_t hash, const char* vname);
+
+    /**
+     * Find index into the table of uniform variable. Return LGL_FAIL if not found.
+     */
+    inline int FindUniform(std::uint32_t hash, const char* vname) const
+    {
+        auto it = std::lower_bound(uniformHashes.begin(), uniformHashes.end(), hash);
+        // names might collide on hash, thus check all the names with the same hash
+        for (; it != uniformHashes.end() && *it == hash; ++it)
+        {
+            const int index = static_cast<int>(it - uniformHashes.begin());
+            if (std::strcmp(uniforms[index].name.c_str(), vname) == 0)
+                return index;
+        }
+        return LGL_FAIL;
+    }
 };
 
 }
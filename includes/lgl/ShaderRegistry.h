@@ -0,0 +1,100 @@
+#ifndef _SHADER_REGISTRY_H_
+#define _SHADER_REGISTRY_H_
+
+#include "Shader.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lgl
+{
+
+/*
+====================
+Shader registry
+====================
+*/
+
+/**
+ * Process-wide registry of shader programs shared by their sources.
+ * Acquiring shader with the same vertex and fragment shader sources returns the same lgl::Shader,
+ * so N instances of the same primitive cost only one compilation and one OpenGL program object.
+ * Variants of the same sources specialised with different set of defines are cached separately.
+ *
+ * Shared shader is reference-counted, call Release() when done with it instead of
+ * Shader::Destroy(). As shader is shared, users should set all per-object uniform values
+ * (i.e. model matrix, color) right before drawing each object.
+ *
+ * Not thread-safe, it's meant to be used only from thread that owns OpenGL context.
+ */
+class ShaderRegistry
+{
+public:
+    /**
+     * Get shared shader built from input sources, build it if it's not built yet.
+     *
+     * \param vertexShaderStr Vertex shader code as null-terminated string
+     * \param fragmentShaderStr Fragment shader code as null-terminated string
+     * \param defines Feature defines to build variant with, see Shader::InjectDefines()
+     * \return Shared shader, or nullptr if error occurs in building it.
+     */
+    static Shader* Acquire(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines = ShaderDefines());
+
+    /**
+     * Same as Acquire() but only start building shader, see Shader::BuildFromSrcAsync().
+     * Acquire all shaders this way up front, do other work, then call FinishAll() before using any of them.
+     *
+     * \return Shared shader, or nullptr if error occurs in starting to build it.
+     */
+    static Shader* AcquireAsync(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines = ShaderDefines());
+
+    /**
+     * Whether all shaders acquired via AcquireAsync() have completed building, so FinishAll() won't block.
+     */
+    static bool IsAllReady();
+
+    /**
+     * Wait for all shaders acquired via AcquireAsync() to complete building, and check their results.
+     * Shaders failed to build are taken out of registry so acquiring them again builds them anew,
+     * they stay valid until released.
+     *
+     * \return Return 0 if all shaders are built successfully, otherwise LGL_FAIL if any of them has error.
+     */
+    static int FinishAll();
+
+    /**
+     * Release shared shader acquired via Acquire(). The shader is destroyed when no one uses it anymore.
+     */
+    static void Release(Shader* shader);
+
+    /**
+     * Get number of programs currently alive in the registry.
+     */
+    static std::size_t GetNumPrograms();
+
+private:
+    struct Entry
+    {
+        Shader shader;
+        std::string vertexShaderStr;        // with defines injected
+        std::string fragmentShaderStr;
+        unsigned int refCount;
+    };
+
+    // keyed by hash of both sources with defines injected, different sources colliding on the same
+    // hash share its bucket. Entries are allocated separately so shaders handed out stay put.
+    typedef std::vector<std::unique_ptr<Entry>> Bucket;
+    static std::unordered_map<std::uint64_t, Bucket> entries;
+    // failed to build but still acquired, not found by Acquire() anymore, destroyed when released
+    static Bucket failedEntries;
+
+    static Shader* Acquire(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines, bool async);
+    static void RetireFailed(Bucket& bucket, std::size_t index);
+};
+
+}
+
+#endif // _SHADER_REGISTRY_H_
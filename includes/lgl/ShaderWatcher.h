@@ -0,0 +1,124 @@
+#ifndef _SHADER_WATCHER_H_
+#define _SHADER_WATCHER_H_
+
+#include "Shader.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lgl
+{
+
+/*
+====================
+Shader watcher
+====================
+*/
+
+/**
+ * Hot-reload shaders built from files whenever any of their source files is changed on disk.
+ *
+ * Background thread waits for file changes via inotify (Linux only), and only records which files
+ * are changed. Rebuilding happens on the thread that owns OpenGL context when Poll() is called
+ * i.e. once per frame. It's built asynchronously (see Shader::BuildAsync()) while the old program
+ * stays in use, then swapped in via Shader::ReplaceProgram() only when linking succeeds.
+ * If there is any error, error is printed and the old program is kept.
+ *
+ * Directories of watched files are watched instead of files themselves, so changes made by editors
+ * which save by writing into a new file then renaming it over are still caught.
+ */
+class ShaderWatcher
+{
+public:
+    /**
+     * Called after shader has its program replaced, i.e. to resolve uniform locations again.
+     */
+    typedef std::function<void(Shader& shader)> ReloadCallback;
+
+    ShaderWatcher();
+    ~ShaderWatcher();
+
+    /**
+     * Start watching for file changes on background thread.
+     *
+     * \return Return 0 for success, otherwise LGL_FAIL if file watching is not supported on this platform.
+     */
+    int Start();
+
+    /**
+     * Stop background thread, and stop watching all files.
+     */
+    void Stop();
+
+    /**
+     * Watch source files of shader which has been built via Shader::Build() from the same files.
+     * Shader has to outlive this watcher, or be unwatched via Unwatch().
+     *
+     * \param shader Shader to have its program replaced when source files are changed
+     * \param vertexPath Path to vertex shader file
+     * \param fragmentPath Path to fragment shader file
+     * \param defines Feature defines shader was built with, so the same variant is rebuilt
+     * \param onReload Optional callback after program of shader is replaced
+     * \return Return 0 for success, otherwise LGL_FAIL if directory of either file cannot be watched.
+     */
+    int Watch(Shader& shader, const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines = ShaderDefines(), const ReloadCallback& onReload = ReloadCallback());
+
+    void Unwatch(const Shader& shader);
+
+    /**
+     * Start rebuilding shaders whose files are changed, and swap in ones that finished building.
+     * Call this on the thread that owns OpenGL context, i.e. once per frame. It doesn't block
+     * waiting for compilation when driver supports GL_KHR_parallel_shader_compile.
+     *
+     * \return Number of shaders whose program is replaced in this call.
+     */
+    int Poll();
+
+private:
+    struct Entry
+    {
+        Shader* shader;
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string vertexWatchPath;        // path as reported by watch, see MakeWatchPath()
+        std::string fragmentWatchPath;
+        ShaderDefines defines;
+        ReloadCallback onReload;
+        Shader building;                    // new program being built, valid if isBuilding
+        bool isBuilding;
+        bool isDirty;                       // files changed again while building
+    };
+
+    struct WatchedDir
+    {
+        int wd;
+        std::string dir;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<WatchedDir> watchedDirs;
+
+    int inotifyFd;
+    std::thread thread;
+    std::atomic<bool> running;
+
+    // files reported as changed by background thread, guarded by mutex along with watchedDirs
+    std::mutex mutex;
+    std::vector<std::string> changedPaths;
+
+    void ThreadMain();
+    int WatchDir(const std::string& dir);
+    void StartRebuild(Entry& entry);
+
+    /**
+     * Split path into directory, and directory + "/" + file name which is how changed file is reported.
+     */
+    static std::string MakeWatchPath(const char* path, std::string& dir);
+};
+
+}
+
+#endif // _SHADER_WATCHER_H_
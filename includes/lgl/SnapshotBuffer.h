@@ -0,0 +1,104 @@
+#ifndef _SNAPSHOT_BUFFER_H_
+#define _SNAPSHOT_BUFFER_H_
+
+#include <atomic>
+
+namespace lgl
+{
+
+/*
+====================
+Snapshot buffer
+====================
+*/
+
+/**
+ * Lock-free triple buffer handing the latest complete snapshot of state from exactly one producer
+ * thread to exactly one consumer thread, i.e. from update thread to render thread.
+ *
+ * Producer fills a slot of its own and publishes it, consumer acquires the latest published one
+ * and reads it until it acquires again. Third slot holds the latest published one in between, so
+ * neither side ever waits for the other nor sees a slot being written. Snapshots published faster
+ * than they're acquired are skipped, never queued. Double buffering would make producer wait for
+ * consumer to let go of its slot.
+ *
+ * \tparam T Snapshot type, copied into by producer so keep it plain
+ */
+template <typename T>
+class SnapshotBuffer
+{
+public:
+    SnapshotBuffer():
+        writeIndex(0),
+        readIndex(1),
+        hasRead(false),
+        latest(2)
+    {
+    }
+
+    /**
+     * Slot to fill in for next snapshot, call this only from producer thread.
+     * It's left with a snapshot from 3 publishes ago, so write all of it.
+     */
+    T& BeginWrite()
+    {
+        return slots[writeIndex].value;
+    }
+
+    /**
+     * Publish slot returned by BeginWrite() as the latest snapshot, call this only from producer thread.
+     */
+    void Publish()
+    {
+        // release so snapshot written is visible to consumer, acquire to take slot consumer let go of
+        writeIndex = latest.exchange(writeIndex | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    /**
+     * Latest published snapshot, call this only from consumer thread. It stays valid and unchanged
+     * until next call.
+     *
+     * \return Latest snapshot, or the one acquired before if nothing is published since. nullptr if
+     *         nothing is published yet.
+     */
+    const T* Acquire()
+    {
+        if ((latest.load(std::memory_order_relaxed) & kFreshBit) != 0)
+        {
+            readIndex = latest.exchange(readIndex, std::memory_order_acq_rel) & kIndexMask;
+            hasRead = true;
+        }
+        return hasRead ? &slots[readIndex].value : nullptr;
+    }
+
+    /**
+     * Whether a snapshot is published since consumer acquired the last one.
+     */
+    bool HasNew() const
+    {
+        return (latest.load(std::memory_order_relaxed) & kFreshBit) != 0;
+    }
+
+private:
+    static const unsigned int kIndexMask = 3u;
+    static const unsigned int kFreshBit = 4u;
+
+    // each on its own cache line so producer and consumer don't bounce the same line
+    struct alignas(64) Slot
+    {
+        T value;
+    };
+
+    Slot slots[3];
+    // owned by producer
+    alignas(64) unsigned int writeIndex;
+    // owned by consumer
+    alignas(64) unsigned int readIndex;
+    bool hasRead;
+    // index of slot in between, with kFreshBit if it's published but not yet acquired
+    alignas(64) std::atomic<unsigned int> latest;
+};
+
+}
+
+#endif // _SNAPSHOT_BUFFER_H_
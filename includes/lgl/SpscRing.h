@@ -0,0 +1,88 @@
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+
+#include <atomic>
+#include <cstddef>
+
+namespace lgl
+{
+
+/*
+====================
+SPSC ring
+====================
+*/
+
+/**
+ * Fixed-capacity lock-free queue for exactly one producer thread and one consumer thread.
+ * Neither side ever blocks, TryPush() fails when it's full and TryPop() fails when it's empty.
+ *
+ * Producer only writes tail and consumer only writes head, each is read by the other side with
+ * acquire so element written before the index is published is visible. They are on separate
+ * cache lines so both sides don't bounce the same line.
+ *
+ * \tparam T Element type, copied in and out
+ * \tparam N Capacity, must be power of two
+ */
+template <typename T, std::size_t N>
+class SpscRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "capacity of SpscRing must be power of two");
+
+public:
+    SpscRing():
+        head(0),
+        tail(0)
+    {
+    }
+
+    /**
+     * Push element, call this only from producer thread.
+     *
+     * \return Whether it's pushed, false if ring is full
+     */
+    bool TryPush(const T& value)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N)
+            return false;
+
+        elements[t & (N - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop the oldest element, call this only from consumer thread.
+     *
+     * \return Whether an element is popped into value, false if ring is empty
+     */
+    bool TryPop(T& value)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (tail.load(std::memory_order_acquire) == h)
+            return false;
+
+        value = elements[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Whether it's empty, exact only when called from consumer thread.
+     */
+    bool IsEmpty() const
+    {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_relaxed);
+    }
+
+private:
+    // indices grow forever, wrapped into elements by mask
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+    alignas(64) T elements[N];
+};
+
+}
+
+#endif // _SPSC_RING_H_
@@ -0,0 +1,130 @@
+#ifndef _TEXTURE_ATLAS_H_
+#define _TEXTURE_ATLAS_H_
+
+#include "Wrapped_GL.h"
+#include <vector>
+
+namespace lgl
+{
+
+/**
+ * Location of image packed into TextureAtlas, see TextureAtlas::GetRect().
+ * Texture coordinates cover only the image itself, not its gutter.
+ */
+struct AtlasRect
+{
+    int page;       // index of atlas texture, see TextureAtlas::GetTexture()
+    float u0;       // bottom-left texture coordinate
+    float v0;
+    float u1;       // top-right texture coordinate
+    float v1;
+};
+
+/*
+====================
+Texture atlas
+====================
+*/
+
+/**
+ * Pack many small images into a few large textures (pages), so quads textured by different images
+ * can be drawn with a single texture bind and draw call.
+ *
+ * Images are packed by skyline packer (imstb_rectpack.h vendored with imgui), each surrounded by gutter
+ * of its edge pixels repeated so bilinear filtering never bleeds neighbours in. Each image with its
+ * gutter occupies whole cells of 2^maxMipLevel pixels, so mipmaps up to maxMipLevel never mix
+ * texels of different images either. Pages are RGBA8 with sRGB-correct mipmaps generated on CPU.
+ *
+ * Usage: Create(), Add() images, Build(), then draw with GetTexture() and GetRect().
+ * Not thread-safe, it's meant to be used only from thread that owns OpenGL context.
+ */
+class TextureAtlas
+{
+public:
+    TextureAtlas();
+
+    /**
+     * Set up atlas, no texture is created until Build().
+     *
+     * \param pageWidth Width of each page
+     * \param pageHeight Height of each page
+     * \param gutter Pixels of repeated edge around each image, it should be at least 2^maxMipLevel
+     *               for bilinear filtering to stay within image at the smallest level
+     * \param maxMipLevel The smallest mipmap level, it's also GL_TEXTURE_MAX_LEVEL of pages
+     */
+    void Create(int pageWidth = 2048, int pageHeight = 2048, int gutter = 4, int maxMipLevel = 2);
+
+    /**
+     * Queue image from file to be packed. It's flipped vertically the same as lgl::util::LoadTexture() does.
+     *
+     * \return Id of image to get its rect via GetRect() after Build(), otherwise LGL_FAIL if it cannot be loaded.
+     */
+    int Add(const char* filepath);
+
+    /**
+     * Queue image from memory to be packed. Pixels are copied.
+     *
+     * \param pixels Tightly packed 8-bit pixels with bottom row first
+     * \param width Width of image
+     * \param height Height of image
+     * \param nrChannels Number of channels, 1 to 4. Images are expanded to RGBA.
+     * \return Id of image to get its rect via GetRect() after Build().
+     */
+    int Add(const unsigned char* pixels, int width, int height, int nrChannels);
+
+    /**
+     * Pack all queued images into pages, and upload them. Pages built previously are replaced,
+     * so ids of previously added images stay valid but their rects may change.
+     *
+     * \return Return 0 for success, otherwise LGL_FAIL if any image with its gutter doesn't fit in a page.
+     */
+    int Build();
+
+    /**
+     * Delete all pages and images.
+     */
+    void Destroy();
+
+    inline const AtlasRect& GetRect(int id) const
+    {
+        return rects[id];
+    }
+
+    inline GLuint GetTexture(int page) const
+    {
+        return pages[page];
+    }
+
+    inline int GetNumPages() const
+    {
+        return static_cast<int>(pages.size());
+    }
+
+    inline int GetNumImages() const
+    {
+        return static_cast<int>(images.size());
+    }
+
+private:
+    struct Image
+    {
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;  // RGBA
+    };
+
+    int pageWidth;
+    int pageHeight;
+    int gutter;
+    int maxMipLevel;
+    std::vector<Image> images;
+    std::vector<AtlasRect> rects;
+    std::vector<GLuint> pages;
+
+    void Blit(const Image& image, int x, int y, int regionWidth, int regionHeight, std::vector<unsigned char>& page) const;
+    void DeletePages();
+};
+
+}
+
+#endif // _TEXTURE_ATLAS_H_
@@ -0,0 +1,105 @@
+#ifndef _TEXTURE_CACHE_H_
+#define _TEXTURE_CACHE_H_
+
+#include "Wrapped_GL.h"
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace lgl
+{
+
+/**
+ * Counters of TextureCache, see TextureCache::GetStats().
+ */
+struct TextureCacheStats
+{
+    unsigned int hits;          // texture is already resident
+    unsigned int misses;        // texture is loaded from file
+    unsigned int evictions;     // unused textures deleted to stay within budget
+    std::size_t bytesResident;  // estimated video memory of all resident textures
+};
+
+/*
+====================
+Texture cache
+====================
+*/
+
+/**
+ * Process-wide cache of textures shared by their filepath.
+ * Acquiring the same file returns the same texture object, so it's decoded and uploaded only once.
+ *
+ * Shared texture is reference-counted, call Release() when done with it instead of glDeleteTextures().
+ * Released texture stays resident so it can be acquired again cheaply, until resident textures
+ * exceed video memory budget then the least recently released ones are deleted first. Textures still
+ * in use are never deleted, so budget can be exceeded if they alone don't fit.
+ *
+ * As texture is shared, don't modify its parameters. Bind lgl::Sampler::Get() of wrapping and
+ * filtering needed to the same texture unit instead, so the same texture can be sampled differently.
+ * Not thread-safe, it's meant to be used only from thread that owns OpenGL context.
+ */
+class TextureCache
+{
+public:
+    /**
+     * Get shared texture loaded from file, load it if it's not resident.
+     *
+     * \param filepath Filepath to image to load
+     * \return Shared texture object with default parameters of lgl::util::LoadTexture(), or 0 if it cannot be loaded.
+     */
+    static GLuint Acquire(const char* filepath);
+
+    /**
+     * Release shared texture acquired via Acquire(). It stays resident until evicted, or Clear() is called.
+     */
+    static void Release(GLuint texture);
+
+    /**
+     * Set video memory budget of resident textures, unused textures are evicted right away if it's exceeded.
+     *
+     * \param bytes Budget in bytes, 0 for unlimited. Default is 256 MB.
+     */
+    static void SetBudget(std::size_t bytes);
+
+    static std::size_t GetBudget();
+
+    /**
+     * Delete all textures not in use.
+     */
+    static void Clear();
+
+    /**
+     * Get number of textures currently resident in the cache, in use or not.
+     */
+    static std::size_t GetNumTextures();
+
+    static const TextureCacheStats& GetStats();
+
+private:
+    struct Entry
+    {
+        GLuint texture;
+        std::size_t bytes;
+        unsigned int refCount;
+        std::list<std::string>::iterator lruIt;     // position in lru, valid only when refCount is 0
+    };
+
+    // keyed by filepath
+    static std::unordered_map<std::string, Entry> entries;
+    static std::unordered_map<GLuint, std::string> keys;
+
+    // keys of textures not in use, the least recently released one at the front
+    static std::list<std::string> lru;
+
+    static std::size_t budget;
+    static TextureCacheStats stats;
+
+    static void Evict(std::size_t maxBytes);
+    static void DeleteLeastRecentlyUsed();
+};
+
+}
+
+#endif // _TEXTURE_CACHE_H_
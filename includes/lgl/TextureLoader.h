@@ -0,0 +1,211 @@
+#ifndef _TEXTURE_LOADER_H_
+#define _TEXTURE_LOADER_H_
+
+#include "Wrapped_GL.h"
+#include "ThreadPool.h"
+#include "PixelBufferRing.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lgl
+{
+
+/**
+ * Counters and timing of TextureLoader, see TextureLoader::GetStats().
+ */
+struct TextureLoaderStats
+{
+    unsigned int requested;     // number of Load() calls
+    unsigned int resident;      // textures uploaded with their image
+    unsigned int failed;        // textures which image cannot be decoded, placeholder is kept
+    double decodeSeconds;       // total time spent decoding on worker threads (summed across threads)
+    double uploadSeconds;       // total time spent uploading on OpenGL thread
+    unsigned int streamed;      // resident textures uploaded from pixel buffer, see EnablePixelBufferStreaming()
+};
+
+/*
+====================
+Texture loader
+====================
+*/
+
+/**
+ * Load textures asynchronously. Images are decoded in parallel on worker threads, while thread
+ * that owns OpenGL context only uploads decoded images within time budget per frame via Update().
+ *
+ * Load() returns texture object right away. It holds 1x1 placeholder until its image is uploaded,
+ * so it can be bound and drawn with immediately. Texture object stays the same after upload.
+ *
+ * With EnablePixelBufferStreaming(), decoded pixels are copied by worker threads into mapped pixel
+ * buffers, so OpenGL thread only issues upload from buffer which driver can copy asynchronously.
+ *
+ * All functions except the ones noted are meant to be called only from thread that owns OpenGL context.
+ */
+class TextureLoader
+{
+public:
+    enum State
+    {
+        STATE_NONE,             // not loaded by this loader
+        STATE_PENDING,          // being decoded, or waiting to be uploaded. Placeholder is in use.
+        STATE_RESIDENT,         // image is uploaded
+        STATE_FAILED            // image cannot be decoded, placeholder stays
+    };
+
+    TextureLoader();
+    ~TextureLoader();
+
+    /**
+     * Start worker threads.
+     * Call this after OpenGL context is created.
+     *
+     * \param numThreads Number of decoding threads, 0 to decide from number of hardware threads
+     */
+    void Start(unsigned int numThreads = 0);
+
+    /**
+     * Stop worker threads, and discard images which are decoded but not uploaded yet.
+     * Textures created so far are not deleted, they're owned by caller.
+     * If pixel buffer streaming is enabled, call this before OpenGL context is destroyed as it deletes
+     * the pixel buffers.
+     */
+    void Stop();
+
+    /**
+     * Stage decoded images through ring of pixel buffers (GL_PIXEL_UNPACK_BUFFER) instead of
+     * uploading from client memory. Buffers are mapped ahead on OpenGL thread, then workers copy
+     * pixels into them right after decoding. Images which don't fit in any mapped buffer, or
+     * are decoded while all buffers are in use, are uploaded from client memory as usual.
+     * Buffers grow to fit the largest image decoded so far.
+     *
+     * Call this after OpenGL context is created, and before Load().
+     *
+     * \param numBuffers Number of pixel buffers, it bounds number of uploads in flight
+     * \param bufferSize Initial size in bytes of each buffer
+     * \return Return 0 for success, otherwise LGL_FAIL and images are uploaded from client memory.
+     */
+    int EnablePixelBufferStreaming(unsigned int numBuffers = 4, std::size_t bufferSize = 4 * 1024 * 1024);
+
+    /**
+     * Generate mipmaps on worker threads right after decoding (see lgl::mipmap), instead of
+     * glGenerateMipmap() on OpenGL thread which is slow on software OpenGL, and not gamma-correct.
+     * Call this before Load().
+     *
+     * \param isSRGB Whether images are sRGB-encoded so their color channels are filtered in linear space
+     */
+    void EnableCpuMipmaps(bool isSRGB = true);
+
+    /**
+     * Create texture object with placeholder, and queue its image to be decoded.
+     * Texture has the same default texture filtering as lgl::util::LoadTexture().
+     *
+     * \param filepath Filepath to image to load
+     * \return Texture object, it's owned by caller so delete it via glDeleteTextures() when done.
+     *         Don't delete it while it's still pending, call Finish() or Stop() first.
+     */
+    GLuint Load(const char* filepath);
+
+    /**
+     * Upload decoded images until time budget is used up, at least one image is uploaded if there is any.
+     * Call this once per frame.
+     *
+     * \param budgetSeconds Time budget for uploading
+     * \return Number of textures uploaded in this call
+     */
+    int Update(double budgetSeconds);
+
+    /**
+     * Block until all queued images are decoded and uploaded.
+     */
+    void Finish();
+
+    State GetState(GLuint texture) const;
+
+    /**
+     * Number of textures which are not resident, nor failed yet.
+     */
+    inline unsigned int GetNumPending() const
+    {
+        return numPending;
+    }
+
+    inline unsigned int GetNumThreads() const
+    {
+        return pool.GetNumThreads();
+    }
+
+    inline const TextureLoaderStats& GetStats() const
+    {
+        return stats;
+    }
+
+    /**
+     * Number of times all pixel buffers were still being read by GPU when refilling them.
+     */
+    inline unsigned int GetNumPixelBufferStalls() const
+    {
+        return pixelBuffers.GetNumStalls();
+    }
+
+    /**
+     * Color of placeholder as RGBA.
+     */
+    void SetPlaceholderColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+
+private:
+    // decoded image waiting to be uploaded
+    struct DecodedImage
+    {
+        GLuint texture;
+        unsigned char* data;    // nullptr if decoding failed
+        int width;
+        int height;
+        int nrChannels;
+        int slot;               // pixel buffer slot which data points into, LGL_FAIL if data is from stb_image
+        bool hasChain;          // data holds full mipmap chain allocated via new[], otherwise base level from stb_image
+    };
+
+    // mapped pixel buffer ready to be written by worker thread
+    struct StagingBuffer
+    {
+        int slot;
+        void* data;
+        std::size_t capacity;
+    };
+
+    ThreadPool pool;
+    std::atomic<bool> stopping;     // tells workers to skip decoding remaining images
+    unsigned char placeholderColor[4];
+    unsigned int numPending;
+    TextureLoaderStats stats;
+    std::unordered_map<GLuint, State> states;
+
+    bool isStreaming;
+    bool isCpuMipmap;
+    bool isSRGB;
+    PixelBufferRing pixelBuffers;
+
+    // guards decodedImages, stagingBuffers, stagingSize and decodeSeconds of stats, as they're
+    // accessed by worker threads
+    mutable std::mutex mutex;
+    std::vector<DecodedImage> decodedImages;
+    std::vector<StagingBuffer> stagingBuffers;
+    std::size_t stagingSize;        // size of the largest image decoded so far, or initial buffer size
+
+    // images taken from decodedImages, waiting for budget to be uploaded. Only touched by OpenGL thread.
+    std::deque<DecodedImage> uploadQueue;
+
+    void Decode(GLuint texture, const std::string& filepath);
+    void Stage(DecodedImage& image, std::size_t size);
+    void RefillStagingBuffers();
+    void Upload(const DecodedImage& image);
+    static void FreePixels(const DecodedImage& image);
+};
+
+}
+
+#endif // _TEXTURE_LOADER_H_
@@ -0,0 +1,112 @@
+#ifndef _TEXTURE_UNITS_H_
+#define _TEXTURE_UNITS_H_
+
+#include "Wrapped_GL.h"
+#include <cstdint>
+
+namespace lgl
+{
+
+/**
+ * Counters of TextureUnits, see TextureUnits::GetStats().
+ */
+struct TextureBindStats
+{
+    unsigned int bindsIssued;           // glBindTexture() and glBindSampler() called
+    unsigned int bindsSkipped;          // the same object is already bound to the unit
+    unsigned int unitSwitchesIssued;    // glActiveTexture() called
+    unsigned int unitSwitchesSkipped;   // the unit is already active, or nothing needs to be bound to it
+};
+
+/*
+====================
+Texture units
+====================
+*/
+
+/**
+ * Shadow of GL_TEXTURE_2D texture and sampler bound to each texture unit, and of active unit.
+ * Binding the same object to the same unit again is skipped without calling OpenGL, and the unit
+ * is only made active when something actually needs to be bound to it.
+ *
+ * Everything is unknown until it's bound through here, so the first bind always goes to OpenGL.
+ * lgl binds textures it creates or uploads through here. Call Invalidate() after binding directly
+ * via glActiveTexture(), glBindTexture() or glBindSampler(), and ForgetTexture() when deleting texture
+ * which might be bound as OpenGL unbinds it.
+ *
+ * Not thread-safe, it's meant to be used only from thread that owns OpenGL context.
+ */
+class TextureUnits
+{
+public:
+    static const GLuint kMaxUnits = 32;     // units beyond are always bound without shadowing
+
+    /**
+     * Bind 2D texture to texture unit.
+     *
+     * \param unit Texture unit, 0 for GL_TEXTURE0
+     * \param texture Texture object, 0 to unbind
+     */
+    static void BindTexture(GLuint unit, GLuint texture);
+
+    /**
+     * Bind 2D texture to whichever unit is active, i.e. only to create it, upload into it or set
+     * its parameters.
+     */
+    static void BindTextureForUpdate(GLuint texture);
+
+    /**
+     * Bind sampler object to texture unit, see lgl::Sampler.
+     *
+     * \param unit Texture unit, 0 for GL_TEXTURE0
+     * \param sampler Sampler object, 0 to sample with parameters of texture itself
+     */
+    static void BindSampler(GLuint unit, GLuint sampler);
+
+    /**
+     * Forget texture wherever it's shadowed as bound, call this when deleting it.
+     */
+    static void ForgetTexture(GLuint texture);
+
+    /**
+     * Forget sampler wherever it's shadowed as bound, call this when deleting it.
+     */
+    static void ForgetSampler(GLuint sampler);
+
+    /**
+     * Forget everything bound, so next bind of any object will call OpenGL.
+     */
+    static void Invalidate();
+
+    static const TextureBindStats& GetStats();
+
+    static void ResetStats();
+
+private:
+    static GLuint activeUnit;
+    static GLuint textures[kMaxUnits];
+    static GLuint samplers[kMaxUnits];
+    static std::uint32_t knownTextures;     // bit per unit, whether its entry of textures is known
+    static std::uint32_t knownSamplers;
+    static TextureBindStats stats;
+
+    static void ActivateUnit(GLuint unit);
+
+    static inline bool IsShadowed(std::uint32_t known, const GLuint* bound, GLuint unit, GLuint object)
+    {
+        return unit < kMaxUnits && (known & (1u << unit)) != 0 && bound[unit] == object;
+    }
+
+    static inline void Shadow(std::uint32_t& known, GLuint* bound, GLuint unit, GLuint object)
+    {
+        if (unit < kMaxUnits)
+        {
+            known |= 1u << unit;
+            bound[unit] = object;
+        }
+    }
+};
+
+}
+
+#endif // _TEXTURE_UNITS_H_
@@ -0,0 +1,72 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lgl
+{
+
+/*
+====================
+Thread pool
+====================
+*/
+
+/**
+ * Fixed number of worker threads running submitted tasks in FIFO order.
+ * Tasks must not call any OpenGL function as worker threads don't have OpenGL context.
+ */
+class ThreadPool
+{
+public:
+    ThreadPool();
+    ~ThreadPool();
+
+    /**
+     * Start worker threads.
+     *
+     * \param numThreads Number of worker threads, 0 to use number of hardware threads minus one
+     *                   (for the thread that owns OpenGL context) but at least one.
+     */
+    void Start(unsigned int numThreads = 0);
+
+    /**
+     * Wait for all submitted tasks to finish, then stop all worker threads.
+     */
+    void Stop();
+
+    /**
+     * Queue task to be run on any of worker threads.
+     */
+    void Submit(const std::function<void()>& task);
+
+    /**
+     * Wait until all submitted tasks are finished.
+     */
+    void WaitIdle();
+
+    inline unsigned int GetNumThreads() const
+    {
+        return static_cast<unsigned int>(threads.size());
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable idle;
+    unsigned int numBusy;       // tasks being run
+    bool stopping;
+
+    void WorkerMain();
+};
+
+}
+
+#endif // _THREAD_POOL_H_
@@ -0,0 +1,162 @@
+#ifndef _UNIFORM_BLOCK_H_
+#define _UNIFORM_BLOCK_H_
+
+#include "Wrapped_GL.h"
+#include "Types.h"
+#include <cstddef>
+#include <vector>
+
+#define LGL_EXTERNAL_GLM_INCLUDE
+#include "lgl/External.h"
+
+namespace lgl
+{
+
+/*
+====================
+std140 layout
+====================
+*/
+
+/**
+ * Compute offsets of members of uniform block declared with layout (std140), in the same order
+ * as declared in GLSL.
+ *
+ * For example, the following GLSL block
+ *
+ *  layout (std140) uniform Camera
+ *  {
+ *      mat4 view;
+ *      mat4 projection;
+ *      vec3 position;
+ *  };
+ *
+ * can be computed with
+ *
+ *  lgl::Std140Layout layout;
+ *  const std::size_t viewOffset = layout.AddMat4();
+ *  const std::size_t projectionOffset = layout.AddMat4();
+ *  const std::size_t positionOffset = layout.AddVec3();
+ *  const std::size_t blockSize = layout.GetSize();
+ */
+class Std140Layout
+{
+public:
+    Std140Layout(): offset(0) { }
+
+    /**
+     * Add member(s) of scalar or vector type, return its offset in bytes.
+     * Each element of array is aligned to 16 bytes as per std140 rule.
+     *
+     * \param count Number of array elements, 1 for non-array
+     */
+    inline std::size_t AddFloat(std::size_t count=1) { return Add(4, 4, count); }
+    inline std::size_t AddInt(std::size_t count=1) { return Add(4, 4, count); }
+    inline std::size_t AddVec2(std::size_t count=1) { return Add(8, 8, count); }
+    inline std::size_t AddVec3(std::size_t count=1) { return Add(16, 12, count); }
+    inline std::size_t AddVec4(std::size_t count=1) { return Add(16, 16, count); }
+
+    /**
+     * Add member(s) of matrix type, return its offset in bytes.
+     * Matrix is laid out as array of its column vectors, each aligned to 16 bytes.
+     */
+    inline std::size_t AddMat3(std::size_t count=1) { return Add(16, 16, 3 * count); }
+    inline std::size_t AddMat4(std::size_t count=1) { return Add(16, 16, 4 * count); }
+
+    /**
+     * Get total size in bytes of the block, rounded up to 16 bytes.
+     */
+    inline std::size_t GetSize() const { return AlignUp(offset, 16); }
+
+    static inline std::size_t AlignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+private:
+    std::size_t offset;
+
+    inline std::size_t Add(std::size_t alignment, std::size_t size, std::size_t count)
+    {
+        if (count > 1)
+        {
+            // array element has both its alignment and stride rounded up to vec4
+            alignment = 16;
+            size = AlignUp(size, 16) * count;
+        }
+
+        const std::size_t start = AlignUp(offset, alignment);
+        offset = start + size;
+        return start;
+    }
+};
+
+/*
+====================
+Uniform block
+====================
+*/
+
+/**
+ * Uniform buffer object bound to a fixed binding point, so it can be shared across multiple
+ * shader programs. See Shader::BindUniformBlock() to associate shader's uniform block with binding point.
+ *
+ * Values are set into CPU-side copy first with std140 layout, then uploaded once via Upload()
+ * which uploads only the range that has been changed. Typical usage is to set values whenever
+ * they change i.e. camera moves, then call Upload() once per frame before drawing.
+ */
+class UniformBlock
+{
+public:
+    UniformBlock();
+
+    /**
+     * Create buffer object, and bind it to bindingPoint. Creating again destroys buffer of previous one.
+     *
+     * \param size Size in bytes of the block, see Std140Layout::GetSize()
+     * \param bindingPoint Binding point to bind buffer to, it should be less than GL_MAX_UNIFORM_BUFFER_BINDINGS
+     * \param usage Usage hint of buffer object
+     * \return Return 0 for success, otherwise error occurs.
+     */
+    int Create(std::size_t size, GLuint bindingPoint, GLenum usage=GL_DYNAMIC_DRAW);
+
+    /**
+     * Destroy buffer object.
+     */
+    void Destroy();
+
+    /** Value setting functions, offset is in bytes as computed by Std140Layout **/
+    void Set(std::size_t offset, GLfloat value);
+    void Set(std::size_t offset, GLint value);
+    void Set(std::size_t offset, const glm::vec2& value);
+    void Set(std::size_t offset, const glm::vec3& value);
+    void Set(std::size_t offset, const glm::vec4& value);
+    void Set(std::size_t offset, const glm::mat3& value);
+    void Set(std::size_t offset, const glm::mat4& value);
+
+    /**
+     * Upload changed range of values to buffer object.
+     * Nothing will be done if there's no change since last upload.
+     */
+    void Upload();
+
+    inline GLuint GetBuffer() const { return ubo; }
+    inline GLuint GetBindingPoint() const { return bindingPoint; }
+
+private:
+    GLuint ubo;
+    GLuint bindingPoint;
+
+    // CPU-side copy of the whole block
+    std::vector<unsigned char> data;
+
+    // range of changed bytes since last upload, dirtyBegin >= dirtyEnd means nothing is changed
+    std::size_t dirtyBegin;
+    std::size_t dirtyEnd;
+
+    void Write(std::size_t offset, const void* value, std::size_t size);
+};
+
+}
+
+#endif // _UNIFORM_BLOCK_H_
@@ -34,6 +34,40 @@ GLuint LoadTexture(const char* filepath);
  */
 GLuint LoadTexture(const char* filepath, int *width, int *height, int *nrChannels);
 
+/**
+ * Upload tightly packed 8-bit pixels into currently bound GL_TEXTURE_2D, then generate its mipmaps.
+ *
+ * \param width Width of image
+ * \param height Height of image
+ * \param nrChannels Number of channels, 1 to 4
+ * \param data Pixels, or nullptr to read from currently bound GL_PIXEL_UNPACK_BUFFER at offset 0
+ */
+void UploadTexture2D(int width, int height, int nrChannels, const void* data);
+
+/**
+ * Upload tightly packed 8-bit pixels along with their mipmaps generated on CPU (see lgl::mipmap::GenerateChain())
+ * into currently bound GL_TEXTURE_2D, without glGenerateMipmap().
+ *
+ * \param width Width of base level
+ * \param height Height of base level
+ * \param nrChannels Number of channels, 1 to 4
+ * \param chain All levels packed one after another starting from base level, or nullptr to read them
+ *              from currently bound GL_PIXEL_UNPACK_BUFFER at offset 0
+ */
+void UploadTexture2DChain(int width, int height, int nrChannels, const void* chain);
+
+/**
+ * Load texture baked by src/TextureBaker (.lgt, see lgl/BakedTexture.h) with the same default texture
+ * filtering as LoadTexture(). File is read through lgl::vfs without copy unless compressed in archive, and its levels are uploaded as they are, without
+ * decoding nor generating mipmaps. Block-compressed texture requires GL_EXT_texture_compression_s3tc.
+ *
+ * \param filepath Filepath to baked texture to load
+ * \param width To be filled with width of loaded texture if load successfully, otherwise no change. It can be nullptr.
+ * \param height To be filled with height of loaded texture if load successfully, otherwise no change. It can be nullptr.
+ * \return Texture object for loaded texture, otherwise LGL_FAIL if file is invalid or its format is not supported.
+ */
+GLuint LoadBakedTexture(const char* filepath, int* width = nullptr, int* height = nullptr);
+
 /* 
 ====================
 File reader
@@ -46,34 +80,89 @@ public:
 
     /**
      * Read Ascii text from file.
+     * Whole file is read at once into string sized up front. Text always ends with newline as if it's
+     * read line by line.
      *
      * \param filePath File path to read text from
      * \param error Error flag to be set if there's any error occur, otherwise it's set to false.
      * \return All read text
      */
-    inline const std::string ReadAll(const char* filePath, bool& error) const
+    inline std::string ReadAll(const char* filePath, bool& error) const
     {
-        std::string line;
-        std::ifstream file(filePath);
-        std::stringstream ss;
-        
-        if (file.is_open())
+        std::string text;
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
         {
-            while (std::getline(file, line))
-            {
-                ss << line << std::endl;
-            }
-            
-            file.close();
-            error = false;
+            error = true;
+            return text;
         }
-        else
+
+        const std::streamoff size = file.tellg();
+        if (size > 0)
         {
-            error = true;
+            text.resize(static_cast<std::size_t>(size));
+            file.seekg(0, std::ios::beg);
+            file.read(&text[0], size);
+            if (file.gcount() != size)
+            {
+                error = true;
+                return std::string();
+            }
+            if (text.back() != '\n')
+                text += '\n';
         }
 
-        return ss.str();
+        error = false;
+        return text;
+    }
+};
+
+/**
+ * Read-only view of whole file memory-mapped, no copy of its content is made.
+ * Content is not null-terminated, use it along with GetSize(). It stays valid until Close(), or
+ * this view is destroyed.
+ */
+class FileView
+{
+public:
+    FileView();
+    ~FileView();
+
+    FileView(FileView&& other);
+    FileView& operator=(FileView&& other);
+
+    /**
+     * Map file, previously mapped file is closed.
+     *
+     * \param filePath File path to map
+     * \return Return 0 for success, otherwise LGL_FAIL.
+     */
+    int Open(const char* filePath);
+
+    void Close();
+
+    inline const char* GetData() const
+    {
+        return data;
+    }
+
+    inline std::size_t GetSize() const
+    {
+        return size;
     }
+
+    inline bool IsOpen() const
+    {
+        return data != nullptr;
+    }
+
+private:
+    const char* data;
+    std::size_t size;
+    bool isMapped;      // empty file has nothing to map
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
 };
 
 }
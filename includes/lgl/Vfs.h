@@ -0,0 +1,117 @@
+#ifndef _VFS_H_
+#define _VFS_H_
+
+#include "Util.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Virtual file system to read assets from either directories or packed archives (.lgp, see
+ * lgl/PackFile.h) through the same paths, i.e. "data/shaders/Basic.vert".
+ *
+ * Mounts are searched from the last mounted one, and path not found in any of them falls back to
+ * be read from file system as it is, so nothing needs to be mounted to read loose files.
+ * Archive is opened and memory-mapped once when mounted, then its entries are read without any
+ * further file system access which matters on network file system.
+ *
+ * lgl::util::LoadTexture(), lgl::util::LoadBakedTexture(), lgl::Shader, lgl::TextureLoader and
+ * lgl::TextureAtlas read their files through this.
+ *
+ * Reading is thread-safe, but mounting and unmounting are not. Mount before any file is read, i.e.
+ * before lgl::TextureLoader starts loading, and unmount only when nothing is being read.
+ */
+
+namespace lgl
+{
+namespace vfs
+{
+
+/**
+ * Content of file read through vfs.
+ * Content of uncompressed entry of archive, or of loose file points directly into memory-mapped
+ * file, otherwise it's owned by this. Content is not null-terminated, use it along with GetSize().
+ * It stays valid until this is destroyed, or archive it's read from is unmounted.
+ */
+class FileData
+{
+public:
+    FileData();
+
+    FileData(FileData&& other);
+    FileData& operator=(FileData&& other);
+
+    inline const unsigned char* GetData() const
+    {
+        return data;
+    }
+
+    inline std::size_t GetSize() const
+    {
+        return size;
+    }
+
+private:
+    friend int Open(const char* path, FileData& file);
+
+    const unsigned char* data;
+    std::size_t size;
+    std::vector<unsigned char> storage;     // decompressed content
+    util::FileView view;                    // loose file
+
+    FileData(const FileData&) = delete;
+    FileData& operator=(const FileData&) = delete;
+};
+
+/**
+ * Mount directory so path under mountPoint is read from directory instead.
+ * i.e. MountDirectory("../../data", "data") reads "data/shaders/Basic.vert" from "../../data/shaders/Basic.vert".
+ *
+ * \param directory Directory path
+ * \param mountPoint Path prefix to be resolved by this mount, empty to resolve all paths
+ * \return Return 0 for success, otherwise LGL_FAIL if directory doesn't exist.
+ */
+int MountDirectory(const char* directory, const char* mountPoint = "");
+
+/**
+ * Mount packed archive so path under mountPoint is read from its entries.
+ * i.e. archive packed from data/ directory is mounted with MountArchive("data.lgp", "data").
+ *
+ * \param filepath Filepath to packed archive
+ * \param mountPoint Path prefix to be resolved by this mount, empty to resolve all paths
+ * \return Return 0 for success, otherwise LGL_FAIL if archive cannot be opened or is not valid.
+ */
+int MountArchive(const char* filepath, const char* mountPoint = "");
+
+/**
+ * Unmount all directories and archives. Content read from archives becomes invalid.
+ */
+void UnmountAll();
+
+/**
+ * Whether file exists in any mount, or in file system.
+ */
+bool Exists(const char* path);
+
+/**
+ * Read whole file.
+ *
+ * \param path Path to file
+ * \param file To be filled with content of file
+ * \return Return 0 for success, otherwise LGL_FAIL.
+ */
+int Open(const char* path, FileData& file);
+
+/**
+ * Read whole text file. Text always ends with newline the same as lgl::util::FileReader::ReadAll().
+ *
+ * \param path Path to file
+ * \param text To be filled with text
+ * \return Return 0 for success, otherwise LGL_FAIL.
+ */
+int ReadText(const char* path, std::string& text);
+
+}
+}
+
+#endif // _VFS_H_
@@ -0,0 +1,205 @@
+#ifndef _VIRTUAL_TEXTURE_H_
+#define _VIRTUAL_TEXTURE_H_
+
+#include "Wrapped_GL.h"
+#include "ThreadPool.h"
+#include "PagedTexture.h"
+#include "Vfs.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace lgl
+{
+
+class Shader;
+
+/**
+ * Counters of VirtualTexture, see VirtualTexture::GetStats().
+ */
+struct VirtualTextureStats
+{
+    unsigned int requested;     // distinct pages seen in the last feedback read back
+    unsigned int missing;       // of those, pages which were not resident
+    unsigned int resident;      // pages in physical cache, including the pinned coarsest level
+    unsigned int uploaded;      // total pages uploaded
+    unsigned int evicted;       // total pages evicted to make room
+    unsigned int feedbacks;     // total feedbacks read back
+};
+
+/*
+====================
+Virtual texture
+====================
+*/
+
+/**
+ * Texture streamed by pages (see lgl/PagedTexture.h) as they're seen on screen, so video memory is
+ * bounded by size of physical page cache regardless of size of image.
+ *
+ * - Physical cache is a single texture holding cacheSize x cacheSize pages, the least recently seen
+ *   ones are replaced first. Pages of the coarsest level are pinned, so there is always something
+ *   to sample.
+ * - Page table is a texture with a texel per page of level 0 plus mipmaps for the rest, each texel
+ *   points to cache slot of its page, or of its nearest resident coarser page.
+ * - Feedback pass renders scene at low resolution with shader writing page each pixel needs, then
+ *   it's read back asynchronously through pixel buffers and consumed a frame or two later.
+ * - Requested pages are read from memory-mapped page file on worker threads, and uploaded by Update().
+ *
+ * Per frame: BeginFeedback(), draw with feedback shader after BindFeedback(), EndFeedback(), Update(),
+ * then draw with shader after Bind(). See data/vt.frag and data/vt_feedback.frag for GLSL side,
+ * and src/_OOP/VirtualTexture.cpp.
+ *
+ * Only a single level is sampled bilinearly at a time without trilinear filtering, and texture
+ * coordinates are clamped to edge.
+ * All functions are meant to be called only from thread that owns OpenGL context.
+ */
+class VirtualTexture
+{
+public:
+    VirtualTexture();
+    ~VirtualTexture();
+
+    /**
+     * Open page file and create page table, physical cache and feedback framebuffer.
+     * Pages of the coarsest level are uploaded right away.
+     *
+     * \param filepath Filepath to page file (.lgv) read through lgl::vfs, keep it uncompressed in archive
+     *                 otherwise it's decompressed whole into memory
+     * \param cacheSize Number of pages per side of physical cache, at most 256
+     * \param feedbackWidth Width of feedback framebuffer
+     * \param feedbackHeight Height of feedback framebuffer
+     * \param numThreads Number of threads reading pages
+     * \return Return 0 for success, otherwise LGL_FAIL.
+     */
+    int Create(const char* filepath, int cacheSize = 16, int feedbackWidth = 160, int feedbackHeight = 90, unsigned int numThreads = 2);
+
+    /**
+     * Delete all textures, buffers and framebuffer, and wait for pages being read.
+     */
+    void Destroy();
+
+    /**
+     * Bind feedback framebuffer and clear it. Viewport is set to size of feedback framebuffer, and
+     * lod bias for BindFeedback() is computed from the viewport it replaces.
+     */
+    void BeginFeedback();
+
+    /**
+     * Start reading back feedback into pixel buffer, then restore framebuffer and viewport.
+     */
+    void EndFeedback();
+
+    /**
+     * Consume feedback which is read back already, queue reading of missing pages, upload pages
+     * which are read, then update page table.
+     *
+     * \param maxUploads Maximum number of pages to upload in this call
+     * \return Number of pages uploaded in this call
+     */
+    int Update(int maxUploads = 16);
+
+    /**
+     * Bind page table and physical cache, and set uniforms of shader sampling this virtual texture.
+     * Required: shader is in use.
+     *
+     * \param shader Shader with uniforms as declared in data/vt.frag
+     * \param firstUnit Texture unit to bind page table to, physical cache is bound to the next one
+     */
+    void Bind(Shader& shader, int firstUnit = 0);
+
+    /**
+     * Set uniforms of feedback shader.
+     * Required: shader is in use, call this between BeginFeedback() and EndFeedback().
+     *
+     * \param shader Shader with uniforms as declared in data/vt_feedback.frag
+     */
+    void BindFeedback(Shader& shader);
+
+    inline const VirtualTextureStats& GetStats() const
+    {
+        return stats;
+    }
+
+    inline int GetWidth() const
+    {
+        return static_cast<int>(header.width);
+    }
+
+    inline int GetHeight() const
+    {
+        return static_cast<int>(header.height);
+    }
+
+private:
+    // page read by worker thread, waiting to be uploaded
+    struct LoadedPage
+    {
+        std::uint32_t page;
+        std::vector<unsigned char> data;
+    };
+
+    struct Slot
+    {
+        int page;                   // LGL_FAIL if free
+        std::uint32_t lastUsed;     // frame it was last needed
+        bool isPinned;
+    };
+
+    vfs::FileData file;
+    paged::FileHeader header;
+    ThreadPool pool;
+
+    GLuint pageTable;
+    GLuint physical;
+    int cacheSize;
+    std::vector<Slot> slots;
+    std::vector<int> pageSlots;                             // slot of each page, LGL_FAIL if not resident
+    std::vector<unsigned char> pageLoading;                 // whether page is being read
+    std::vector<std::uint32_t> pageRequested;               // frame page was last requested
+    std::vector<std::uint32_t> levelFirstPage;              // index of the first page of each level
+    std::vector<std::vector<std::uint32_t>> tableLevels;    // RGBA8 texels of page table
+    std::vector<std::uint32_t> missingPages;                // requested but not resident, coarsest first
+    bool isTableDirty;
+    std::uint32_t frame;
+    unsigned int numLoading;
+
+    GLuint feedbackFramebuffer;
+    GLuint feedbackColor;
+    GLuint feedbackDepth;
+    int feedbackWidth;
+    int feedbackHeight;
+    float feedbackLodBias;
+    GLuint readbackBuffers[2];
+    GLsync readbackFences[2];
+    int readbackIndex;                  // the next one to read back into
+    GLint savedFramebuffer;
+    GLint savedViewport[4];
+    GLfloat savedClearColor[4];
+
+    // guards loadedPages, as it's filled by worker threads
+    std::mutex mutex;
+    std::vector<LoadedPage> loadedPages;
+
+    VirtualTextureStats stats;
+
+    void SetUniforms(Shader& shader, float lodBias);
+    void ConsumeFeedback();
+    void ProcessFeedback(const unsigned char* pixels);
+    void LoadPage(std::uint32_t page);
+    int FindSlot();
+    void UploadPage(std::uint32_t page, const unsigned char* data, int slot);
+    void UpdatePageTable();
+
+    inline std::uint32_t GetPageIndex(std::uint32_t level, std::uint32_t x, std::uint32_t y) const
+    {
+        return levelFirstPage[level] + y * (header.pagesX >> level) + x;
+    }
+
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+};
+
+}
+
+#endif // _VIRTUAL_TEXTURE_H_
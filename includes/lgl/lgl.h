@@ -5,6 +5,25 @@
 #include "lgl/Util.h"
 #include "lgl/Error.h"
 #include "lgl/Shader.h"
+#include "lgl/UniformBlock.h"
+#include "lgl/Ext.h"
+#include "lgl/ProgramCache.h"
+#include "lgl/ShaderRegistry.h"
+#include "lgl/ShaderWatcher.h"
+#include "lgl/ThreadPool.h"
+#include "lgl/TextureLoader.h"
+#include "lgl/PixelBufferRing.h"
+#include "lgl/TextureCache.h"
+#include "lgl/Mipmap.h"
+#include "lgl/TextureAtlas.h"
+#include "lgl/Vfs.h"
+#include "lgl/VirtualTexture.h"
+#include "lgl/Sampler.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/SpscRing.h"
+#include "lgl/DebugOutput.h"
+#include "lgl/Log.h"
+#include "lgl/SnapshotBuffer.h"
 #include <GLFW/glfw3.h>
 
 // include the most frequently used at this level
@@ -28,6 +28,7 @@ if [ "$1" == "build" ]; then
         -Iexternals/stb_image \
         -Iexternals/glm \
         -Iincludes \
+        -Iexternals \
         src/lgl/*.cpp \
         externals/glad/src/glad.c \
         $2 \
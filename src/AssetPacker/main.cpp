@@ -0,0 +1,195 @@
+/// Asset packer
+/// Pack all files under a directory into a single archive (.lgp) which lgl::vfs::MountArchive() mounts,
+/// see lgl/PackFile.h. Entries are named by their path relative to the directory.
+///
+/// Usage: assetpacker.out [-c] -o <output.lgp> <directory>
+///
+///     -c  Compress entries with LZ4, each one is stored compressed only if it gets smaller
+///         (already compressed images such as jpg and png mostly don't)
+///     -o  Output archive
+///
+/// i.e. to pack data/ which demos then mount with lgl::vfs::MountArchive("data.lgp", "data")
+///     ./assetpacker.out -c -o ../../data.lgp ../../data
+#include "lgl/PackFile.h"
+#include "lgl/Lz4.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+/// Collect relative paths of all regular files under directory, following symlinks.
+static void ListFiles(const std::string& root, const std::string& relative, std::vector<std::string>& files)
+{
+    const std::string dirPath = relative.empty() ? root : root + "/" + relative;
+    DIR* dir = opendir(dirPath.c_str());
+    if (dir == nullptr)
+        return;
+
+    while (dirent* item = readdir(dir))
+    {
+        if (std::strcmp(item->d_name, ".") == 0 || std::strcmp(item->d_name, "..") == 0)
+            continue;
+
+        const std::string name = relative.empty() ? item->d_name : relative + "/" + item->d_name;
+        struct stat st;
+        if (stat((root + "/" + name).c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            ListFiles(root, name, files);
+        else if (S_ISREG(st.st_mode))
+            files.push_back(name);
+    }
+    closedir(dir);
+}
+
+static bool ReadFile(const std::string& path, std::vector<unsigned char>& content)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    content.clear();
+    unsigned char buffer[64 * 1024];
+    std::size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        content.insert(content.end(), buffer, buffer + n);
+    const bool isRead = std::ferror(file) == 0;
+    std::fclose(file);
+    return isRead;
+}
+
+/// Pack files into archive.
+/// Header structs are written as they are, which matches the little-endian file layout on
+/// little-endian hosts this packer is meant to be run on.
+///
+/// \return 0 for success, otherwise -1
+static int Pack(const std::string& root, const std::vector<std::string>& names, const char* outputPath, bool isCompressed)
+{
+    std::vector<lgl::pack::Entry> entries(names.size());
+    std::vector<std::vector<unsigned char>> blobs(names.size());
+    std::string stringTable;
+    std::uint64_t totalSize = 0;
+    for (std::size_t i=0; i<names.size(); ++i)
+    {
+        std::vector<unsigned char> content;
+        if (!ReadFile(root + "/" + names[i], content))
+        {
+            std::fprintf(stderr, "Error reading %s/%s\n", root.c_str(), names[i].c_str());
+            return -1;
+        }
+
+        lgl::pack::Entry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.size = content.size();
+        entry.nameOffset = static_cast<std::uint32_t>(stringTable.size());
+        entry.nameLength = static_cast<std::uint32_t>(names[i].size());
+        entry.compression = lgl::pack::COMPRESSION_NONE;
+        stringTable += names[i];
+        totalSize += content.size();
+
+        if (isCompressed && !content.empty())
+        {
+            std::vector<unsigned char> compressed(lgl::lz4::GetCompressBound(content.size()));
+            compressed.resize(lgl::lz4::CompressBlock(content.data(), content.size(), compressed.data()));
+            if (compressed.size() < content.size())
+            {
+                entry.compression = lgl::pack::COMPRESSION_LZ4;
+                content.swap(compressed);
+            }
+        }
+        entry.storedSize = content.size();
+        blobs[i].swap(content);
+    }
+
+    lgl::pack::Header header;
+    std::memcpy(header.magic, lgl::pack::kMagic, sizeof(header.magic));
+    header.version = lgl::pack::kVersion;
+    header.numEntries = static_cast<std::uint32_t>(entries.size());
+    header.stringTableSize = static_cast<std::uint32_t>(stringTable.size());
+
+    const std::uint64_t alignment = lgl::pack::kDataAlignment;
+    std::uint64_t offset = sizeof(header) + sizeof(lgl::pack::Entry) * entries.size() + stringTable.size();
+    for (lgl::pack::Entry& entry : entries)
+    {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        entry.offset = offset;
+        offset += entry.storedSize;
+    }
+
+    FILE* file = std::fopen(outputPath, "wb");
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Error opening %s for writing\n", outputPath);
+        return -1;
+    }
+
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(entries.data(), sizeof(lgl::pack::Entry), entries.size(), file);
+    std::fwrite(stringTable.data(), 1, stringTable.size(), file);
+    const unsigned char padding[lgl::pack::kDataAlignment] = {};
+    std::uint64_t written = sizeof(header) + sizeof(lgl::pack::Entry) * entries.size() + stringTable.size();
+    for (std::size_t i=0; i<entries.size(); ++i)
+    {
+        std::fwrite(padding, 1, entries[i].offset - written, file);
+        std::fwrite(blobs[i].data(), 1, blobs[i].size(), file);
+        written = entries[i].offset + entries[i].storedSize;
+    }
+
+    const bool isWritten = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!isWritten)
+    {
+        std::fprintf(stderr, "Error writing %s\n", outputPath);
+        return -1;
+    }
+
+    for (std::size_t i=0; i<entries.size(); ++i)
+    {
+        std::printf("%s (%llu -> %llu bytes%s)\n", names[i].c_str(), static_cast<unsigned long long>(entries[i].size),
+                    static_cast<unsigned long long>(entries[i].storedSize), entries[i].compression == lgl::pack::COMPRESSION_LZ4 ? ", lz4" : "");
+    }
+    std::printf("%s -> %s (%zu files, %llu -> %llu bytes)\n", root.c_str(), outputPath, entries.size(),
+                static_cast<unsigned long long>(totalSize), static_cast<unsigned long long>(written));
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* outputPath = nullptr;
+    const char* inputDir = nullptr;
+    bool isCompressed = false;
+    for (int i=1; i<argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (std::strcmp(argv[i], "-c") == 0)
+            isCompressed = true;
+        else
+            inputDir = argv[i];
+    }
+
+    if (outputPath == nullptr || inputDir == nullptr)
+    {
+        std::fprintf(stderr, "Usage: %s [-c] -o <output.lgp> <directory>\n", argv[0]);
+        return 1;
+    }
+
+    std::string root(inputDir);
+    while (root.size() > 1 && root.back() == '/')
+        root.pop_back();
+
+    std::vector<std::string> names;
+    ListFiles(root, "", names);
+    if (names.empty())
+    {
+        std::fprintf(stderr, "No files found in %s\n", inputDir);
+        return 1;
+    }
+    // stable order so the same input produces the same archive
+    std::sort(names.begin(), names.end());
+
+    return Pack(root, names, outputPath, isCompressed) == 0 ? 0 : 1;
+}
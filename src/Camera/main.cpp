@@ -159,7 +159,7 @@ void initGL()
     glEnable(GL_DEPTH_TEST);
     
     // create shader
-    int result = shader.Build("data/tex2.vert", "data/multitex.frag");
+    int result = shader.Build("data/tex.vert", "data/multitex.frag", { "MVP_TRANSFORM" });
     LGL_ERROR_QUIT(result, "Error creating shader");
 
     // load textures
@@ -196,21 +196,17 @@ void initGL()
     std::cout << "OpenGL version in use: " << majorVersion << "." << minorVersion << std::endl;
     
     // create shader
-    int result = shader.Build("data/tex2.vert", "data/multitex.frag");
+    int result = shader.Build("data/tex.vert", "data/multitex.frag", { "MVP_TRANSFORM" });
     LGL_ERROR_QUIT(result, "Error creating shader");
 
-    // load textures
-    containerTexture = lgl::util::LoadTexture("data/container.jpg");
-    if (lgl::error::AnyGLError() != 0)
+    // load textures via shared cache with default filtering, sampler object bound to unit 0 below
+    // filters it differently without a separate copy of the texture
+    containerTexture = lgl::TextureCache::Acquire("data/container.jpg");
+    if (containerTexture == 0)
         lgl::error::ErrorExit("Error loading data/container.jpg");
-    // modify its texture filtering
-    glBindTexture(GL_TEXTURE_2D, containerTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    awesomeTexture = lgl::util::LoadTexture("data/awesomeface.png");
-    if (lgl::error::AnyGLError() != 0)
+
+    awesomeTexture = lgl::TextureCache::Acquire("data/awesomeface.png");
+    if (awesomeTexture == 0)
         lgl::error::ErrorExit("Error loading data/awesomeface.png");
 
     // prepare vao
@@ -224,15 +220,14 @@ void initGL()
 
         glEnableVertexAttribArray(0);
         glEnableVertexAttribArray(1);
-
-        glBindTexture(GL_TEXTURE_2D, containerTexture);
     glBindVertexArray(0);
 
+    // sampler object overrides filtering of whichever texture is bound to unit 0
+    lgl::TextureUnits::BindSampler(0, lgl::Sampler::Get(lgl::TextureSampling(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_NEAREST)));
+
     // set uniform values
     shader.Use();
-    glActiveTexture(GL_TEXTURE0);
     shader.SetUniform("textureSampler", 0);
-    glActiveTexture(GL_TEXTURE1);
     shader.SetUniform("textureSampler2", 1);
     shader.SetUniform("mixFactor", 0.5f);
 
@@ -316,12 +311,9 @@ void render()
     glViewport(0, 0, static_cast<GLsizei>(screenWidth), static_cast<GLsizei>(screenHeight));
 
     shader.Use();
-    // bind 1st texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, containerTexture);
-    // bind 2nd texture
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, awesomeTexture);
+    // bind textures, skipped when they are still bound from previous frame
+    lgl::TextureUnits::BindTexture(0, containerTexture);
+    lgl::TextureUnits::BindTexture(1, awesomeTexture);
 
     glBindVertexArray(vao);
         // two version of implementations provided: 1. via GLM 2. Self-implemented
@@ -348,9 +340,9 @@ void renderGUI()
     
     if (isGuiWindowShow)
     {
-        ImGui::SetNextWindowSize(ImVec2(400, 200));
-        ImGui::SetNextWindowSizeConstraints(ImVec2(400, 200), ImVec2(400,200));
-        ImGui::SetNextWindowPos(ImVec2(screenWidth / 2 - 5, screenHeight-200-5));
+        ImGui::SetNextWindowSize(ImVec2(400, 220));
+        ImGui::SetNextWindowSizeConstraints(ImVec2(400, 220), ImVec2(400,220));
+        ImGui::SetNextWindowPos(ImVec2(screenWidth / 2 - 5, screenHeight-220-5));
         ImGui::Begin("CameraImgui (fixed pos & size, SPACE to reopen)", &isGuiWindowShow);
 
         //static bool mm = true;
@@ -380,6 +372,9 @@ void renderGUI()
         ImGui::Text("Cam Pos: %.02f, %.02f, %.02f", camPos.x, camPos.y, camPos.z);
         ImGui::Text("Cam Front: %.02f, %.02f, %.02f", camFront.x, camFront.y, camFront.y); 
 
+        const lgl::TextureBindStats& bindStats = lgl::TextureUnits::GetStats();
+        ImGui::Text("Texture binds: %u issued, %u skipped", bindStats.bindsIssued, bindStats.bindsSkipped);
+
         ImGui::End();
     }
 
@@ -626,6 +621,10 @@ void destroyMem()
     glDeleteBuffers(2, gizmoVBO);
     shader.Destroy();
     gizmoShader.Destroy();
+    lgl::TextureCache::Release(containerTexture);
+    lgl::TextureCache::Release(awesomeTexture);
+    lgl::TextureCache::Clear();
+    lgl::Sampler::Clear();
 }
 
 int main(int argc, char** argv)
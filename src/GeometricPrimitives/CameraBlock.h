@@ -0,0 +1,16 @@
+#ifndef CAMERA_BLOCK_H_
+#define CAMERA_BLOCK_H_
+
+/// Binding point of uniform block "Camera" shared by all shaders (except Gizmo's) in this program.
+/// It is declared in GLSL as
+///
+///     layout (std140) uniform Camera
+///     {
+///         mat4 view;
+///         mat4 projection;
+///     };
+///
+/// then each shader associates its block to this binding point via lgl::Shader::BindUniformBlock().
+#define CAMERA_BLOCK_BINDING 0
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef COLOR_SHADER_H_
+#define COLOR_SHADER_H_
+
+/// Sources of solid color shader used by main program, Sphere and Line.
+/// They are acquired through lgl::ShaderRegistry with exactly these sources, so all of them share a
+/// single program. Uniforms are "model" (mat4) and "color" (vec3), view and projection matrix are read
+/// from uniform block "Camera" (see CameraBlock.h).
+static const char* const kColorVertexShaderStr = R"(#version 330 core
+#extension GL_ARB_explicit_uniform_location : require
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+};
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+})";
+
+static const char* const kColorFragmentShaderStr = R"(#version 330 core
+uniform vec3 color;
+out vec4 fsColor;
+void main()
+{
+    fsColor = vec4(color, 1.0); 
+}
+)";
+
+#endif
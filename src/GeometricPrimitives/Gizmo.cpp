@@ -105,6 +105,11 @@ void main()
     int result = shader.BuildFromSrc(vertexShaderStr, fragmentShaderStr);
     LGL_ERROR_QUIT(result, "Error creating gizmo shader");
 
+    modelLoc = shader.GetUniformLocation("model");
+    viewLoc = shader.GetUniformLocation("view");
+    projectionLoc = shader.GetUniformLocation("projection");
+    colorLoc = shader.GetUniformLocation("color");
+
     // vertex buffers for gizmo
     glGenVertexArrays(2, vao);
     glGenBuffers(2, vbo);
@@ -125,7 +130,7 @@ void main()
     glBindVertexArray(0);
 
     shader.Use();
-    glUniform3f(shader.GetUniformLocation("color"), 0.7f, 0.7f, 0.7);
+    shader.SetUniform(colorLoc, glm::vec3(0.7f, 0.7f, 0.7f));
 
     // create a fake view matrix (identity matrix) as we don't want to require user to send in
     // view matrix at this time. Also it is probably be updated soon at the first frame, or at the
@@ -134,8 +139,8 @@ void main()
     viewCopy[3][0] = 0.0f;
     viewCopy[3][1] = 0.0f;
     viewCopy[3][2] = -1.0f;     // move the camera back slightly to see all angle of object
-    glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(viewCopy));
-    glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+    shader.SetUniform(viewLoc, viewCopy);
+    shader.SetUniform(projectionLoc, projectionMatrix);
 }
 
 void Gizmo::draw()
@@ -152,15 +157,15 @@ void Gizmo::draw()
     viewCopy[3][0] = 0.0f;
     viewCopy[3][1] = 0.0f;
     viewCopy[3][2] = -1.0f;
-    glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(viewCopy));
+    shader.SetUniform(viewLoc, viewCopy);
 
     glBindVertexArray(vao[0]);
         // draw box
         {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::scale(model, glm::vec3(0.15f));
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 0.7f, 0.7f, 0.7f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(0.7f, 0.7f, 0.7f));
         glDrawArrays(GL_TRIANGLES, 0, 36);
         }
 
@@ -169,8 +174,8 @@ void Gizmo::draw()
         // y-axis
         {
         glm::mat4 model = glm::mat4(1.0f);
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 0.0f, 1.0f, 0.0f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(0.0f, 1.0f, 0.0f));
         glDrawArrays(GL_LINES, 0, 6);
         }
 
@@ -178,8 +183,8 @@ void Gizmo::draw()
         {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 1.0f, 0.0f, 0.0f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(1.0f, 0.0f, 0.0f));
         glDrawArrays(GL_LINES, 0, 6);
         }
 
@@ -187,8 +192,8 @@ void Gizmo::draw()
         {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 0.0f, 0.0f, 1.0f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(0.0f, 0.0f, 1.0f));
         glDrawArrays(GL_LINES, 0, 6);
         }
 
@@ -200,8 +205,8 @@ void Gizmo::draw()
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, dir);
         model = glm::scale(model, glm::vec3(0.03f));
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 0.0f, 0.7f, 0.0f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(0.0f, 0.7f, 0.0f));
         glDrawArrays(GL_TRIANGLES, 0, 36);
         }   
 
@@ -212,8 +217,8 @@ void Gizmo::draw()
         model = glm::translate(model, dir);
         model = glm::scale(model, glm::vec3(0.03f));
         model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 0.7f, 0.0f, 0.0f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(0.7f, 0.0f, 0.0f));
         glDrawArrays(GL_TRIANGLES, 0, 36);
         }   
 
@@ -224,8 +229,8 @@ void Gizmo::draw()
         model = glm::translate(model, dir);
         model = glm::scale(model, glm::vec3(0.03f));
         model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform3f(shader.GetUniformLocation("color"), 0.0f, 0.0f, 0.7f);
+        shader.SetUniform(modelLoc, model);
+        shader.SetUniform(colorLoc, glm::vec3(0.0f, 0.0f, 0.7f));
         glDrawArrays(GL_TRIANGLES, 0, 36);
         }    
     glBindVertexArray(0);
@@ -246,12 +251,12 @@ void Gizmo::updateViewMatrix(const glm::mat4& view)
     viewCopy[3][2] = -1.0f; // move camera back slightly to see the gizmo itself
 
     shader.Use();
-    glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(viewCopy));
+    shader.SetUniform(viewLoc, viewCopy);
 }
 
 void Gizmo::updateProjectionMatrix(const glm::mat4& projection)
 {
     projectionMatrix = projection;
     shader.Use();
-    glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+    shader.SetUniform(projectionLoc, projectionMatrix);
 }
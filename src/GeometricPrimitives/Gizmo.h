@@ -39,6 +39,10 @@ private:
     GLuint vao[2];
     GLuint vbo[2];
     lgl::Shader shader;
+    GLint modelLoc;
+    GLint viewLoc;
+    GLint projectionLoc;
+    GLint colorLoc;
     GLint prevViewport[4];
     GLint gizmoViewport[4];
 
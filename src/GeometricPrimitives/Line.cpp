@@ -1,11 +1,14 @@
 #include "Line.h"
+#include "lgl/ShaderRegistry.h"
+#include "ColorShader.h"
 
 void Line::initialInitialize(const LineData& ldata)
 {
     spec_vao = 0;
     spec_vbo = 0;
-    isShaderBuilt = false;
+    shader = nullptr;
     lineColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    model = glm::mat4(1.0f);
     t = 1.0f;
     lineData = ldata;
     lineDataDraw[0] = lineData.pos;
@@ -16,8 +19,9 @@ void Line::initialInitialize(const LineData&& ldata)
 {
     spec_vao = 0;
     spec_vbo = 0;
-    isShaderBuilt = false;
+    shader = nullptr;
     lineColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    model = glm::mat4(1.0f);
     t = 1.0f;
     lineData = ldata;
     lineDataDraw[0] = lineData.pos;
@@ -40,10 +44,10 @@ void Line::destroyVertexBuffersIfNeeded()
 
 void Line::destroyShaderIfNeeded()
 {
-    if (isShaderBuilt)
+    if (shader != nullptr)
     {
-        shader.Destroy();
-        isShaderBuilt = false;
+        lgl::ShaderRegistry::Release(shader);
+        shader = nullptr;
     }
 }
 
@@ -52,32 +56,13 @@ void Line::build()
     destroyVertexBuffersIfNeeded();
     destroyShaderIfNeeded();
 
-    const char* vertexShaderStr = R"(#version 330 core
-#extension GL_ARB_explicit_uniform_location : require
+    shader = lgl::ShaderRegistry::Acquire(kColorVertexShaderStr, kColorFragmentShaderStr);
+    if (shader == nullptr)
+        lgl::error::ErrorExit("Error creating shader");
 
-layout (location = 0) in vec3 aPos;
-
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-})";
-
-    const char* fragmentShaderStr = R"(#version 330 core
-uniform vec3 color;
-out vec4 fsColor;
-
-void main()
-{
-    fsColor = vec4(color, 1.0); 
-})";
-
-    int result = shader.BuildFromSrc(vertexShaderStr, fragmentShaderStr);
-    LGL_ERROR_QUIT(result, "Error creating shader");
-    isShaderBuilt = true;
+    modelLoc = shader->GetUniformLocation("model");
+    colorLoc = shader->GetUniformLocation("color");
+    shader->BindUniformBlock("Camera", CAMERA_BLOCK_BINDING);
 
     glGenVertexArrays(1, &spec_vao);
     glGenBuffers(1, &spec_vbo);
@@ -86,11 +71,8 @@ void main()
     std::cout << glm::to_string(lineDataDraw[0]) << std::endl;
     std::cout << glm::to_string(lineDataDraw[1]) << std::endl;
 
-    shader.Use();
-    
     glBindVertexArray(spec_vao);
         glBindBuffer(GL_ARRAY_BUFFER, spec_vbo);
-        glUniform3f(shader.GetUniformLocation("color"), lineColor.x, lineColor.y, lineColor.z);
 
         glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, lineDataDraw, GL_STREAM_DRAW);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
@@ -107,7 +89,7 @@ void Line::destroyGLObjects()
 
 void Line::draw() const
 {
-    shader.Use();
+    applyUniforms();
     glBindVertexArray(spec_vao);
         glDrawArrays(GL_LINES, 0, 2);
     glBindVertexArray(0);
@@ -115,7 +97,7 @@ void Line::draw() const
 
 void Line::drawBatchBegin() const
 {
-    shader.Use();
+    applyUniforms();
     glBindVertexArray(spec_vao);
 }
 
@@ -135,17 +117,15 @@ void Line::computeLineDataDraw()
     lineDataDraw[1] = lineData.pos + t*lineData.dir;
 }
 
-void Line::updateProjectionMatrix(const glm::mat4& mat)
-{
-    glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(mat));
-}
-
-void Line::updateViewMatrix(const glm::mat4& mat)
+void Line::updateModelMatrix(const glm::mat4& mat)
 {
-    glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(mat));
+    model = mat;
 }
 
-void Line::updateModelMatrix(const glm::mat4& mat)
+void Line::applyUniforms() const
 {
-    glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(mat));
+    // shader is shared with others, so set this object's values every time it's drawn
+    shader->Use();
+    shader->SetUniform(modelLoc, model);
+    shader->SetUniform(colorLoc, lineColor);
 }
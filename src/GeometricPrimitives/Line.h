@@ -2,8 +2,10 @@
 #define LGL_LINE_H
 
 #include "lgl/Shader.h"
+#include "CameraBlock.h"
 #include "lgl/Wrapped_GL.h"
 #include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
 #include <algorithm>
 
 /// LineData
@@ -94,13 +96,10 @@ public:
     void setLineData(const LineData&& ldata);
     const LineData& getLineData() const;
 
-    /// Required: attached shader needs to call Shader::Use() before setting any of the following
-    /// functions.
-    void updateProjectionMatrix(const glm::mat4& mat);
-    void updateViewMatrix(const glm::mat4& mat);
+    /// Model matrix and line color are applied to shader in draw() and drawBatchBegin().
     void updateModelMatrix(const glm::mat4& mat);
 
-    /// build shader 
+    /// acquire shared shader from lgl::ShaderRegistry and build vertex buffers
     void build();
 
     /// destroy any opengl related objects
@@ -120,7 +119,6 @@ public:
     void drawBatchEnd() const;
 
     /// set line color when draw
-    /// Required: shader is active. Call Shader::Use of its Line::shader
     void setLineColor(float r, float g, float b);
     const glm::vec3 getLineColor() const;
 
@@ -128,7 +126,8 @@ public:
     void setT(float v);
     float getT() const;
 
-    lgl::Shader shader;
+    /// shared shader acquired from lgl::ShaderRegistry, valid after build()
+    lgl::Shader* shader;
 
 private:
     void initialInitialize(const LineData& ldata);
@@ -136,6 +135,7 @@ private:
     void destroyVertexBuffersIfNeeded();
     void destroyShaderIfNeeded();
     void computeLineDataDraw();
+    void applyUniforms() const;
 
 private:
     /// for caching the attached line data for drawing performance
@@ -143,13 +143,17 @@ private:
     LineData lineData;
     glm::vec3 lineDataDraw[2];
     glm::vec3 lineColor;
+    glm::mat4 model;
 
     /// t factor to draw the line based on line equation
     float t;
-    bool isShaderBuilt;
 
     GLuint spec_vao;
     GLuint spec_vbo;
+
+    // uniform locations resolved once after shader is built
+    GLint modelLoc;
+    GLint colorLoc;
 };
 
 /// inline implementation
@@ -191,9 +195,6 @@ inline void Line::setLineColor(float r, float g, float b)
     lineColor.r = r;
     lineColor.g = g;
     lineColor.b = b;
-
-    // update to OpenGL
-    glUniform3f(shader.GetUniformLocation("color"), lineColor.x, lineColor.y, lineColor.z);
 }
 
 inline const glm::vec3 Line::getLineColor() const
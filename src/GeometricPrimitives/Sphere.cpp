@@ -1,5 +1,7 @@
 #include "Sphere.h"
 #include "lgl/Error.h"
+#include "lgl/ShaderRegistry.h"
+#include "ColorShader.h"
 
 #define DEFAULT_NUM_STACKS 20
 #define DEFAULT_NUM_SECTORS 20
@@ -9,11 +11,15 @@ Sphere::Sphere(): Sphere(DEFAULT_NUM_STACKS, DEFAULT_NUM_SECTORS, DEFAULT_RADIUS
 { }
 
 Sphere::Sphere(unsigned int numStacks, unsigned int numSectors, float r):
+    shader(nullptr),
     numStacks(numStacks),
     numSectors(numSectors),
     radius(r),
+    spec_vao(0),
+    spec_vbo(0),
+    spec_ebo(0),
     color(glm::vec3(1.0f, 1.0f, 1.0f)),
-    isShaderBuilt(false)
+    model(glm::mat4(1.0f))
 {
     assert(numStacks > 3 && "numStacks must be more than 3 to programmatically generate Sphere vertices");
     assert(numSectors > 3 && "numSectors must be more than 3 to programmatically generate Sphere vertices");
@@ -24,29 +30,13 @@ void Sphere::build()
     destroyVertexBuffersIfNeeded();
     destroyShaderIfNeeded();
 
-    const char* vertexShaderStr = R"(#version 330 core
-#extension GL_ARB_explicit_uniform_location : require
-layout (location = 0) in vec3 aPos;
+    shader = lgl::ShaderRegistry::Acquire(kColorVertexShaderStr, kColorFragmentShaderStr);
+    if (shader == nullptr)
+        lgl::error::ErrorExit("Error creating shader");
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-})";
-    const char* fragmentShaderStr = R"(#version 330 core
-uniform vec3 color;
-out vec4 fsColor;
-void main()
-{
-    fsColor = vec4(color, 1.0); 
-}
-)";
-    int result = shader.BuildFromSrc(vertexShaderStr, fragmentShaderStr);
-    LGL_ERROR_QUIT(result, "Error creating shader");
-    isShaderBuilt = true;
+    modelLoc = shader->GetUniformLocation("model");
+    colorLoc = shader->GetUniformLocation("color");
+    shader->BindUniformBlock("Camera", CAMERA_BLOCK_BINDING);
 
     buildVertexSpecifications();
     setupVertexBuffers();
@@ -73,10 +63,10 @@ void Sphere::destroyVertexBuffersIfNeeded()
 
 void Sphere::destroyShaderIfNeeded()
 {
-    if (isShaderBuilt)
+    if (shader != nullptr)
     {
-        shader.Destroy();
-        isShaderBuilt = false;
+        lgl::ShaderRegistry::Release(shader);
+        shader = nullptr;
     }
 }
 
@@ -88,6 +78,7 @@ void Sphere::destroyGLObjects()
 
 void Sphere::draw() const
 {
+    applyUniforms();
     glBindVertexArray(spec_vao);
         glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
@@ -95,6 +86,7 @@ void Sphere::draw() const
 
 void Sphere::drawBatchBegin() const
 {
+    applyUniforms();
     glBindVertexArray(spec_vao);
 }
 
@@ -175,22 +167,20 @@ void Sphere::setupVertexBuffers()
     glBindVertexArray(0);
 }
 
-void Sphere::updateProjectionMatrix(const glm::mat4& mat)
-{
-    glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(mat));
-}
-
-void Sphere::updateViewMatrix(const glm::mat4& mat)
+void Sphere::updateModelMatrix(const glm::mat4& mat)
 {
-    glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(mat));
+    model = mat;
 }
 
-void Sphere::updateModelMatrix(const glm::mat4& mat)
+void Sphere::setColor(float r, float g, float b)
 {
-    glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(mat));
+    color = glm::vec3(r, g, b);
 }
 
-void Sphere::setColor(float r, float g, float b)
+void Sphere::applyUniforms() const
 {
-    glUniform3f(shader.GetUniformLocation("color"), r, g, b);
+    // shader is shared with others, so set this object's values every time it's drawn
+    shader->Use();
+    shader->SetUniform(modelLoc, model);
+    shader->SetUniform(colorLoc, color);
 }
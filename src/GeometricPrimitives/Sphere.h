@@ -3,6 +3,8 @@
 
 #include <vector>
 #include "lgl/Shader.h"
+#include "glm/mat4x4.hpp"
+#include "CameraBlock.h"
 #include "lgl/Wrapped_GL.h"
 #include "glm/vec3.hpp"
 
@@ -11,9 +13,11 @@
 /// It self-manage VBO + EBO, and provide rendering function.
 ///
 /// User can create Sphere with different level of detail (via numStacks, numSectors and radius) and its
-/// model, view, projection matrix as well as color accordingly (look at trans.vert, and color.frag) can
-/// be configured via its shader. User has to maintain these information externally, Sphere class
-/// doesn't maintain them.
+/// model matrix as well as color. Its shader is shared with other users of the same sources through
+/// lgl::ShaderRegistry, so model matrix and color are kept here and set to shader when drawn.
+/// View and projection matrix are read from uniform block "Camera" bound at CAMERA_BLOCK_BINDING
+/// (see CameraBlock.h). User has to maintain these information externally, Sphere class doesn't
+/// maintain them.
 ///
 /// Provides with batch draw call
 /// (technically this is to bind its own vertex array object at begin, then reset when done)
@@ -23,7 +27,8 @@
 class Sphere
 {
 public:
-    lgl::Shader shader;
+    /// shared shader acquired from lgl::ShaderRegistry, valid after build()
+    lgl::Shader* shader;
 
     Sphere();
     Sphere(unsigned int numStacks, unsigned int numSectors, float r);
@@ -39,13 +44,9 @@ public:
     inline const std::vector<unsigned int>& getIndices() const { return indices; }
     inline float getRadius() const { return radius; }
 
-    /// Required: attached shader needs to call Shader::Use() before setting any of the following
-    /// functions.
-    void updateProjectionMatrix(const glm::mat4& mat);
-    void updateViewMatrix(const glm::mat4& mat);
+    /// Model matrix and color are applied to shader in draw() and drawBatchBegin().
     void updateModelMatrix(const glm::mat4& mat);
 
-    /// Required: attached shader needs to call Shader::Use()
     void setColor(float r, float g, float b);
     const glm::vec3& getColor() const;
 
@@ -54,12 +55,16 @@ private:
     unsigned int numSectors;
     float radius;
 
-    bool isShaderBuilt;
     GLuint spec_vao;
     GLuint spec_vbo;
     GLuint spec_ebo;
 
     glm::vec3 color;
+    glm::mat4 model;
+
+    // uniform locations resolved once after shader is built
+    GLint modelLoc;
+    GLint colorLoc;
 
     std::vector<glm::vec3> vertices;
     std::vector<unsigned int> indices;
@@ -68,6 +73,7 @@ private:
     void setupVertexBuffers();
     void destroyVertexBuffersIfNeeded();
     void destroyShaderIfNeeded();
+    void applyUniforms() const;
 };
 
 /// inline implementations
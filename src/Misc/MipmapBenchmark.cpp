@@ -0,0 +1,79 @@
+/**
+ * Measure time to build full mipmap chain of 2K and 4K images on CPU (lgl::mipmap, SSE2 where
+ * available, linear and sRGB-correct) vs glGenerateMipmap() of current driver.
+ *
+ * Driver time includes waiting for GPU via glFinish(), it's what upload on software OpenGL
+ * (llvmpipe) costs the thread that owns OpenGL context. CPU time runs on the calling thread,
+ * lgl::TextureLoader::EnableCpuMipmaps() does the same on worker threads instead.
+ *
+ * Compile with make.sh, then run from root directory of this repository.
+ */
+#include "lgl/Base.h"
+#include <chrono>
+#include <cstdio>
+
+#define NUM_REPEATS 5
+
+/// Average milliseconds spent in generating mipmap chain on CPU
+static double MeasureCpu(std::vector<unsigned char>& chain, int size, int nrChannels, bool isSRGB)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int i=0; i<NUM_REPEATS; ++i)
+        lgl::mipmap::GenerateChain(chain.data(), size, size, nrChannels, isSRGB);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / NUM_REPEATS;
+}
+
+/// Average milliseconds spent in glGenerateMipmap() until GPU is done
+static double MeasureDriver(const std::vector<unsigned char>& chain, int size, int nrChannels)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    double total = 0.0;
+    for (int i=0; i<NUM_REPEATS; ++i)
+    {
+        // re-specify base level so driver cannot skip work
+        lgl::util::UploadTexture2D(size, size, nrChannels, chain.data());
+        glFinish();
+
+        const double startTime = glfwGetTime();
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glFinish();
+        total += glfwGetTime() - startTime;
+    }
+
+    glDeleteTextures(1, &texture);
+    return total * 1000.0 / NUM_REPEATS;
+}
+
+int main()
+{
+    lgl::App app;
+    if (app.Setup("Mipmap benchmark") != 0)
+        return 1;
+
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << '\n';
+    std::printf("%-6s %-8s %12s %12s %16s\n", "size", "channels", "cpu linear", "cpu srgb", "glGenerateMipmap");
+
+    const int sizes[] = { 2048, 4096 };
+    const int channels[] = { 3, 4 };
+    for (int size : sizes)
+    {
+        for (int nrChannels : channels)
+        {
+            std::vector<unsigned char> chain(lgl::mipmap::GetChainSize(size, size, nrChannels));
+            // gradient with noise, so neither path can take shortcut on uniform blocks
+            for (std::size_t i=0; i<static_cast<std::size_t>(size) * size * nrChannels; ++i)
+                chain[i] = static_cast<unsigned char>((i / nrChannels) % size * 255 / size + (i * 2654435761u >> 28));
+
+            const double cpuLinear = MeasureCpu(chain, size, nrChannels, false);
+            const double cpuSRGB = MeasureCpu(chain, size, nrChannels, true);
+            const double driver = MeasureDriver(chain, size, nrChannels);
+            std::printf("%-6d %-8d %9.2f ms %9.2f ms %13.2f ms\n", size, nrChannels, cpuLinear, cpuSRGB, driver);
+        }
+    }
+
+    glfwTerminate();
+    return 0;
+}
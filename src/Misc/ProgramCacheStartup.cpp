@@ -0,0 +1,58 @@
+/**
+ * Measure time spent building shader programs at startup with and without program binary cache
+ * (see lgl::ProgramCache).
+ *
+ * It builds all shaders in data/ directory, then prints number of programs loaded from cache vs
+ * compiled from source along with time spent on each. Run it twice, the first run populates the
+ * cache into .shadercache/ directory, the second run should load all programs from there.
+ * Delete .shadercache/ directory to start over.
+ *
+ * Compile with make.sh, then run from root directory of this repository.
+ */
+#include "lgl/Base.h"
+
+// vertex shader path, fragment shader path, and define (if any) to build variant with
+static const char* kShaderPaths[][3] = {
+    { "data/basic.vert", "data/basic.frag", nullptr },
+    { "data/color.vert", "data/color.frag", nullptr },
+    { "data/tex.vert", "data/tex.frag", nullptr },
+    { "data/tex.vert", "data/multitex.frag", nullptr },
+    { "data/tex.vert", "data/multitex.frag", "MVP_TRANSFORM" }
+};
+
+int main(int argc, char* argv[])
+{
+    lgl::AppConfigs configs;
+    configs.ProgramCacheDir = ".shadercache";
+
+    lgl::App app;
+    if (app.Setup("Program cache startup", configs) != 0)
+        return 1;
+
+    if (!lgl::ProgramCache::IsEnabled())
+        std::cout << "Program binary is not supported by driver, all programs are compiled from source" << '\n';
+
+    const double startTime = glfwGetTime();
+    for (const auto& paths : kShaderPaths)
+    {
+        lgl::Shader shader;
+        lgl::ShaderDefines defines;
+        if (paths[2] != nullptr)
+            defines.push_back(paths[2]);
+
+        int result = shader.Build(paths[0], paths[1], defines);
+        LGL_ERROR_WARN(result, "Error building shader");
+        if (result == 0)
+            shader.Destroy();
+    }
+    const double totalTime = glfwGetTime() - startTime;
+
+    const lgl::ProgramCacheStats& stats = lgl::ProgramCache::GetStats();
+    std::cout << "Loaded from cache: " << stats.hits << " programs in " << stats.hitSeconds * 1000.0 << " ms" << '\n';
+    std::cout << "Compiled from source: " << stats.misses << " programs in " << stats.missSeconds * 1000.0 << " ms" << '\n';
+    std::cout << "Rejected by driver: " << stats.rejected << '\n';
+    std::cout << "Total: " << totalTime * 1000.0 << " ms" << '\n';
+
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * Stress building shader programs where most of them fail, and check that failed builds don't leak
+ * any OpenGL objects.
+ *
+ * It builds 10,000 programs cycling through a valid one, one with vertex shader compilation error,
+ * one with fragment shader compilation error, and one with linking error. OpenGL doesn't expose
+ * number of live objects, but drivers hand out names of deleted objects again, so name of a newly
+ * created shader and program object are probed once in a while. If any object is leaked, probed
+ * names keep growing.
+ *
+ * Error messages of failed builds are silenced after the first round, so it's clear how they look like
+ * including line numbers mapped back to sources before defines are injected.
+ *
+ * Compile with make.sh, then run from root directory of this repository.
+ */
+#include "lgl/Base.h"
+#include <cstdio>
+
+#define NUM_BUILDS 10000
+#define PROBE_INTERVAL 1000
+// allowance for driver to keep some names around
+#define MAX_NAME_GROWTH 16
+
+static const char* kVertexShaderStr = R"(#version 330 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 model;
+out vec3 vsColor;
+void main()
+{
+#ifdef VERTEX_ERROR
+    gl_Position = model * undeclared;
+#else
+    gl_Position = model * vec4(aPos, 1.0);
+#endif
+    vsColor = aPos;
+})";
+
+static const char* kFragmentShaderStr = R"(#version 330 core
+in vec3 vsColor;
+#ifdef LINK_ERROR
+in vec3 notOutputByVertexShader;
+#endif
+out vec4 fsColor;
+void main()
+{
+#ifdef FRAGMENT_ERROR
+    fsColor = vec3(vsColor);
+#elif defined(LINK_ERROR)
+    fsColor = vec4(notOutputByVertexShader, 1.0);
+#else
+    fsColor = vec4(vsColor, 1.0);
+#endif
+})";
+
+// probe the next name driver hands out for shader and program object
+static void ProbeNames(GLuint& shaderName, GLuint& programName)
+{
+    shaderName = glCreateShader(GL_VERTEX_SHADER);
+    programName = glCreateProgram();
+    glDeleteShader(shaderName);
+    glDeleteProgram(programName);
+}
+
+int main(int argc, char* argv[])
+{
+    lgl::App app;
+    if (app.Setup("Shader build stress") != 0)
+        return 1;
+
+    const lgl::ShaderDefines kCases[] = {
+        lgl::ShaderDefines(),
+        lgl::ShaderDefines(1, "VERTEX_ERROR"),
+        lgl::ShaderDefines(1, "FRAGMENT_ERROR"),
+        lgl::ShaderDefines(1, "LINK_ERROR")
+    };
+    const int kNumCases = sizeof(kCases) / sizeof(kCases[0]);
+
+    GLuint firstShaderName = 0, firstProgramName = 0;
+    GLuint maxShaderName = 0, maxProgramName = 0;
+    int numFailed = 0;
+
+    const double startTime = glfwGetTime();
+    for (int i=0; i<NUM_BUILDS; ++i)
+    {
+        lgl::Shader shader;
+        if (shader.BuildFromSrc(kVertexShaderStr, kFragmentShaderStr, kCases[i % kNumCases]) != 0)
+            ++numFailed;
+        shader.Destroy();
+
+        if (i == kNumCases - 1)
+        {
+            // silence error messages after showing them once
+            lgl::log::SetMuted(true);
+
+            ProbeNames(firstShaderName, firstProgramName);
+        }
+        else if ((i + 1) % PROBE_INTERVAL == 0)
+        {
+            GLuint shaderName, programName;
+            ProbeNames(shaderName, programName);
+            maxShaderName = std::max(maxShaderName, shaderName);
+            maxProgramName = std::max(maxProgramName, programName);
+        }
+    }
+    const double totalTime = glfwGetTime() - startTime;
+
+    lgl::log::SetMuted(false);
+    // print messages of the first round before results
+    lgl::log::Flush();
+
+    std::cout << "Built " << NUM_BUILDS << " programs, " << numFailed << " failed in " << totalTime << " s" << '\n';
+    std::cout << "Shader object name: first probe " << firstShaderName << ", max probe " << maxShaderName << '\n';
+    std::cout << "Program object name: first probe " << firstProgramName << ", max probe " << maxProgramName << '\n';
+
+    const int expectedFailed = NUM_BUILDS - (NUM_BUILDS + kNumCases - 1) / kNumCases;
+    bool passed = numFailed == expectedFailed &&
+                  maxShaderName <= firstShaderName + MAX_NAME_GROWTH &&
+                  maxProgramName <= firstProgramName + MAX_NAME_GROWTH;
+    std::cout << (passed ? "PASSED" : "FAILED: failed builds are not as expected, or object names keep growing") << '\n';
+
+    glfwTerminate();
+    return passed ? 0 : 1;
+}
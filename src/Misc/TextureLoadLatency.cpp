@@ -0,0 +1,145 @@
+/**
+ * Measure latency from starting to load textures to the first frame, and to all textures being
+ * resident, with lgl::util::LoadTexture() (synchronous) vs lgl::TextureLoader (asynchronous), the latter
+ * both uploading from client memory and streaming through pixel buffers.
+ *
+ * It loads all .jpg and .png images in input directory (data/ by default), repeated until there are
+ * at least 100 of them. Every file is read once before measuring so both runs read from OS file cache.
+ *
+ * Usage: <program> [directory]
+ *
+ * Compile with make.sh, then run from root directory of this repository.
+ */
+#include "lgl/Base.h"
+#include <dirent.h>
+#include <fstream>
+#include <algorithm>
+
+#define MIN_NUM_TEXTURES 100
+#define UPLOAD_BUDGET_SECONDS 0.002
+
+static bool HasImageExtension(const std::string& name)
+{
+    const std::size_t dot = name.find_last_of('.');
+    if (dot == std::string::npos)
+        return false;
+    std::string ext = name.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == "jpg" || ext == "jpeg" || ext == "png";
+}
+
+static std::vector<std::string> ListImages(const char* dir)
+{
+    std::vector<std::string> paths;
+    DIR* d = opendir(dir);
+    if (d == nullptr)
+        return paths;
+
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr)
+    {
+        if (HasImageExtension(entry->d_name))
+            paths.push_back(std::string(dir) + "/" + entry->d_name);
+    }
+    closedir(d);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+static void RenderFrame(GLFWwindow* window)
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+    glfwSwapBuffers(window);
+    glfwPollEvents();
+    // make sure frame is really done on GPU before taking time
+    glFinish();
+}
+
+/// Asynchronous: frames keep going with placeholders while textures are uploaded within budget
+static void MeasureAsync(GLFWwindow* window, const std::vector<std::string>& paths, bool isStreaming)
+{
+    std::vector<GLuint> textures(paths.size());
+    lgl::TextureLoader loader;
+    const double startTime = glfwGetTime();
+    loader.Start();
+    if (isStreaming)
+        loader.EnablePixelBufferStreaming();
+    for (std::size_t i=0; i<paths.size(); ++i)
+        textures[i] = loader.Load(paths[i].c_str());
+
+    loader.Update(UPLOAD_BUDGET_SECONDS);
+    RenderFrame(window);
+    const double firstFrameLatency = glfwGetTime() - startTime;
+
+    int numFrames = 1;
+    double maxFrameTime = firstFrameLatency;
+    while (loader.GetNumPending() > 0)
+    {
+        const double frameStartTime = glfwGetTime();
+        loader.Update(UPLOAD_BUDGET_SECONDS);
+        RenderFrame(window);
+        maxFrameTime = std::max(maxFrameTime, glfwGetTime() - frameStartTime);
+        ++numFrames;
+    }
+    const double residentLatency = glfwGetTime() - startTime;
+    const unsigned int numThreads = loader.GetNumThreads();
+    const unsigned int numStalls = loader.GetNumPixelBufferStalls();
+    loader.Stop();
+    glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+    const lgl::TextureLoaderStats& stats = loader.GetStats();
+    const char* name = isStreaming ? "Asynchronous with pixel buffers" : "Asynchronous";
+    std::cout << name << ": first frame after " << firstFrameLatency * 1000.0 << " ms, all resident after "
+              << residentLatency * 1000.0 << " ms over " << numFrames << " frames, longest frame "
+              << maxFrameTime * 1000.0 << " ms" << '\n';
+    std::cout << name << ": decode " << stats.decodeSeconds * 1000.0 << " ms (" << numThreads << " threads), upload "
+              << stats.uploadSeconds * 1000.0 << " ms, failed " << stats.failed;
+    if (isStreaming)
+        std::cout << ", streamed " << stats.streamed << ", stalls " << numStalls;
+    std::cout << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    const char* dir = argc > 1 ? argv[1] : "data";
+    const std::vector<std::string> images = ListImages(dir);
+    if (images.empty())
+    {
+        std::cerr << "No image found in " << dir << '\n';
+        return 1;
+    }
+
+    std::vector<std::string> paths;
+    while (paths.size() < MIN_NUM_TEXTURES)
+        paths.insert(paths.end(), images.begin(), images.end());
+
+    // warm up OS file cache
+    for (const std::string& path : images)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    lgl::App app;
+    if (app.Setup("Texture load latency") != 0)
+        return 1;
+    GLFWwindow* window = app.GetGLFWWindow();
+    std::vector<GLuint> textures(paths.size());
+
+    // synchronous: nothing is drawn until all textures are loaded
+    double startTime = glfwGetTime();
+    for (std::size_t i=0; i<paths.size(); ++i)
+        textures[i] = lgl::util::LoadTexture(paths[i].c_str());
+    RenderFrame(window);
+    const double syncLatency = glfwGetTime() - startTime;
+    glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+    std::cout << "Textures: " << paths.size() << " (" << images.size() << " distinct images)" << '\n';
+    std::cout << "Synchronous: first frame after " << syncLatency * 1000.0 << " ms" << '\n';
+
+    MeasureAsync(window, paths, false);
+    MeasureAsync(window, paths, true);
+
+    glfwTerminate();
+    return 0;
+}
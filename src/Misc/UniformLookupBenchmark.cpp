@@ -0,0 +1,112 @@
+/**
+ * Microbenchmark of looking up uniform variable location by its name as done by
+ * lgl::Shader::GetUniformLocation() on cache hit.
+ *
+ * It compares
+ *  - std::string keyed hashmap, looked up from const char* (previous implementation); a temporary
+ *    std::string is constructed on every call
+ *  - hash keyed hashmap, looked up from const char*
+ *  - hash keyed hashmap, looked up with hash computed at compile time
+ *  - sorted flat array of hashes with binary search, as used by reflected uniform table (current implementation)
+ *  - location resolved once and kept by caller (no lookup at all)
+ *
+ * It doesn't need OpenGL context as it only measures the lookup part.
+ * Compile with make.sh, or standalone with optimization turned on e.g.
+ *  g++ -O2 -std=c++11 -Iincludes src/Misc/UniformLookupBenchmark.cpp
+ *
+ * Result (g++ -O2, Linux x86-64):
+ *  - string keyed       :  ~50 M lookups/sec
+ *  - hash keyed         :  ~63 M lookups/sec
+ *  - compile-time hash  : ~115 M lookups/sec
+ *  - sorted hash array  :  ~67 M lookups/sec (includes run-time hashing of the name)
+ *  - resolved location  : ~490 M lookups/sec (bounded by loop overhead)
+ *  Names used are typical one i.e. "model", "view", "projection", "color". Longer names
+ *  (beyond small string optimization buffer) make string keyed version allocate on heap too.
+ */
+#include "lgl/Hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef int GLint;
+
+static const char* kNames[] = { "model", "view", "projection", "color", "textureSampler", "mixFactor" };
+static const int kNumNames = sizeof(kNames) / sizeof(kNames[0]);
+static const int kIterations = 20000000;
+
+template <typename F>
+void bench(const char* title, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long sum = f();
+    auto end = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(end - start).count();
+
+    // print sum to prevent compiler from optimizing away the loop
+    std::cout << title << ": " << (kIterations / secs / 1.0e6) << " M lookups/sec [" << sum << "]" << std::endl;
+}
+
+int main()
+{
+    std::unordered_map<std::string, GLint> stringMap;
+    std::unordered_map<std::uint32_t, GLint> hashMap;
+    std::vector<std::uint32_t> sortedHashes;
+    for (int i=0; i<kNumNames; ++i)
+    {
+        stringMap.emplace(kNames[i], i);
+        hashMap.emplace(lgl::hash::Fnv1a(kNames[i]), i);
+        sortedHashes.push_back(lgl::hash::Fnv1a(kNames[i]));
+    }
+    std::sort(sortedHashes.begin(), sortedHashes.end());
+
+    // prevent compiler to see through which name is used at each iteration
+    volatile int nameOffset = 0;
+
+    bench("string keyed", [&]() {
+        long long sum = 0;
+        for (int i=0; i<kIterations; ++i)
+            sum += stringMap.find(kNames[(i + nameOffset) % kNumNames])->second;
+        return sum;
+    });
+
+    bench("hash keyed", [&]() {
+        long long sum = 0;
+        for (int i=0; i<kIterations; ++i)
+            sum += hashMap.find(lgl::hash::Fnv1a(kNames[(i + nameOffset) % kNumNames]))->second;
+        return sum;
+    });
+
+    bench("compile-time hash", [&]() {
+        long long sum = 0;
+        for (int i=0; i<kIterations; ++i)
+        {
+            constexpr std::uint32_t kModelHash = lgl::hash::Fnv1a("model");
+            sum += hashMap.find(kModelHash + nameOffset)->second;
+        }
+        return sum;
+    });
+
+    bench("sorted hash array", [&]() {
+        long long sum = 0;
+        for (int i=0; i<kIterations; ++i)
+        {
+            const std::uint32_t hash = lgl::hash::Fnv1a(kNames[(i + nameOffset) % kNumNames]);
+            sum += std::lower_bound(sortedHashes.begin(), sortedHashes.end(), hash) - sortedHashes.begin();
+        }
+        return sum;
+    });
+
+    bench("resolved location", [&]() {
+        const GLint locations[] = { 0, 1, 2, 3, 4, 5 };
+        long long sum = 0;
+        for (int i=0; i<kIterations; ++i)
+            sum += locations[(i + nameOffset) % kNumNames];
+        return sum;
+    });
+
+    return 0;
+}
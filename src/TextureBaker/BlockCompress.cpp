@@ -0,0 +1,194 @@
+#include "BlockCompress.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+static std::uint16_t PackRGB565(const int* rgb)
+{
+    const int r = (rgb[0] * 31 + 127) / 255;
+    const int g = (rgb[1] * 63 + 127) / 255;
+    const int b = (rgb[2] * 31 + 127) / 255;
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(std::uint16_t c, int* rgb)
+{
+    const int r = (c >> 11) & 31;
+    const int g = (c >> 5) & 63;
+    const int b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+/// Find the two extreme colors along principal axis of pixels.
+static void FindEndpoints(const unsigned char* rgba, int* maxColor, int* minColor)
+{
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i=0; i<16; ++i)
+        for (int c=0; c<3; ++c)
+            mean[c] += rgba[i*4 + c];
+    for (int c=0; c<3; ++c)
+        mean[c] /= 16.0f;
+
+    // covariance matrix, symmetric so only 6 of its elements
+    float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i=0; i<16; ++i)
+    {
+        const float r = rgba[i*4 + 0] - mean[0];
+        const float g = rgba[i*4 + 1] - mean[1];
+        const float b = rgba[i*4 + 2] - mean[2];
+        cov[0] += r*r; cov[1] += r*g; cov[2] += r*b;
+        cov[3] += g*g; cov[4] += g*b;
+        cov[5] += b*b;
+    }
+
+    // power iteration converges to principal axis within a few steps for 3x3
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iter=0; iter<4; ++iter)
+    {
+        const float x = cov[0]*axis[0] + cov[1]*axis[1] + cov[2]*axis[2];
+        const float y = cov[1]*axis[0] + cov[3]*axis[1] + cov[4]*axis[2];
+        const float z = cov[2]*axis[0] + cov[4]*axis[1] + cov[5]*axis[2];
+        const float m = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+        if (m == 0.0f)
+            break;
+        axis[0] = x / m;
+        axis[1] = y / m;
+        axis[2] = z / m;
+    }
+
+    int maxIndex = 0, minIndex = 0;
+    float maxDot = -1e30f, minDot = 1e30f;
+    for (int i=0; i<16; ++i)
+    {
+        const float dot = rgba[i*4 + 0]*axis[0] + rgba[i*4 + 1]*axis[1] + rgba[i*4 + 2]*axis[2];
+        if (dot > maxDot) { maxDot = dot; maxIndex = i; }
+        if (dot < minDot) { minDot = dot; minIndex = i; }
+    }
+    for (int c=0; c<3; ++c)
+    {
+        maxColor[c] = rgba[maxIndex*4 + c];
+        minColor[c] = rgba[minIndex*4 + c];
+    }
+}
+
+void CompressBlockBC1(const unsigned char* rgba, unsigned char* out)
+{
+    int maxColor[3], minColor[3];
+    FindEndpoints(rgba, maxColor, minColor);
+
+    std::uint16_t c0 = PackRGB565(maxColor);
+    std::uint16_t c1 = PackRGB565(minColor);
+    // c0 > c1 selects 4-color mode, equal endpoints have only one color anyway
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    int palette[4][3];
+    UnpackRGB565(c0, palette[0]);
+    UnpackRGB565(c1, palette[1]);
+    for (int c=0; c<3; ++c)
+    {
+        palette[2][c] = (2*palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2*palette[1][c]) / 3;
+    }
+
+    std::uint32_t indices = 0;
+    if (c0 != c1)
+    {
+        for (int i=0; i<16; ++i)
+        {
+            int best = 0, bestDist = 0x7FFFFFFF;
+            for (int p=0; p<4; ++p)
+            {
+                const int dr = rgba[i*4 + 0] - palette[p][0];
+                const int dg = rgba[i*4 + 1] - palette[p][1];
+                const int db = rgba[i*4 + 2] - palette[p][2];
+                const int dist = dr*dr + dg*dg + db*db;
+                if (dist < bestDist) { bestDist = dist; best = p; }
+            }
+            indices |= static_cast<std::uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = c0 & 0xFF;
+    out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF;
+    out[3] = c1 >> 8;
+    for (int i=0; i<4; ++i)
+        out[4 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+void CompressBlockBC3(const unsigned char* rgba, unsigned char* out)
+{
+    int a0 = 0, a1 = 255;
+    for (int i=0; i<16; ++i)
+    {
+        a0 = std::max(a0, static_cast<int>(rgba[i*4 + 3]));
+        a1 = std::min(a1, static_cast<int>(rgba[i*4 + 3]));
+    }
+
+    // a0 > a1 selects 8-alpha mode
+    int palette[8];
+    palette[0] = a0;
+    palette[1] = a1;
+    for (int p=1; p<7; ++p)
+        palette[p + 1] = ((7 - p)*a0 + p*a1) / 7;
+
+    std::uint64_t indices = 0;
+    if (a0 != a1)
+    {
+        for (int i=0; i<16; ++i)
+        {
+            int best = 0, bestDist = 256;
+            for (int p=0; p<8; ++p)
+            {
+                const int dist = std::abs(rgba[i*4 + 3] - palette[p]);
+                if (dist < bestDist) { bestDist = dist; best = p; }
+            }
+            indices |= static_cast<std::uint64_t>(best) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(a0);
+    out[1] = static_cast<unsigned char>(a1);
+    for (int i=0; i<6; ++i)
+        out[2 + i] = (indices >> (i * 8)) & 0xFF;
+
+    CompressBlockBC1(rgba, out + 8);
+}
+
+std::vector<unsigned char> CompressImage(const unsigned char* rgba, int width, int height, bool withAlpha)
+{
+    const int blockBytes = withAlpha ? 16 : 8;
+    const int numBlocksX = (width + 3) / 4;
+    const int numBlocksY = (height + 3) / 4;
+    std::vector<unsigned char> blocks(static_cast<std::size_t>(numBlocksX) * numBlocksY * blockBytes);
+
+    unsigned char block[16 * 4];
+    unsigned char* out = blocks.data();
+    for (int by=0; by<numBlocksY; ++by)
+    {
+        for (int bx=0; bx<numBlocksX; ++bx)
+        {
+            for (int y=0; y<4; ++y)
+            {
+                const int sy = std::min(by*4 + y, height - 1);
+                for (int x=0; x<4; ++x)
+                {
+                    const int sx = std::min(bx*4 + x, width - 1);
+                    const unsigned char* src = rgba + (static_cast<std::size_t>(sy) * width + sx) * 4;
+                    std::copy(src, src + 4, block + (y*4 + x) * 4);
+                }
+            }
+
+            if (withAlpha)
+                CompressBlockBC3(block, out);
+            else
+                CompressBlockBC1(block, out);
+            out += blockBytes;
+        }
+    }
+    return blocks;
+}
@@ -0,0 +1,35 @@
+#ifndef LGL_BLOCK_COMPRESS_H
+#define LGL_BLOCK_COMPRESS_H
+
+#include <vector>
+
+/// Block compression
+/// Encode 4x4 blocks of RGBA8 pixels into BC1 (DXT1) or BC3 (DXT5).
+///
+/// Endpoints are the extremes of pixels projected onto principal axis of their colors, then each
+/// pixel picks the nearest of interpolated colors. It's not as good as exhaustive search of endpoints,
+/// but it's fast enough to bake all assets in seconds.
+
+/// Encode a block into 8 bytes of BC1.
+///
+/// \param rgba 16 pixels of 4 bytes each, in row order
+/// \param out 8 bytes to write into
+void CompressBlockBC1(const unsigned char* rgba, unsigned char* out);
+
+/// Encode a block into 16 bytes of BC3, 8 bytes of alpha followed by 8 bytes of color as BC1.
+///
+/// \param rgba 16 pixels of 4 bytes each, in row order
+/// \param out 16 bytes to write into
+void CompressBlockBC3(const unsigned char* rgba, unsigned char* out);
+
+/// Encode whole image, its dimension doesn't have to be multiple of 4 as edge pixels are repeated
+/// to fill partial blocks.
+///
+/// \param rgba Tightly packed RGBA8 pixels
+/// \param width Width of image
+/// \param height Height of image
+/// \param withAlpha Whether to encode as BC3, otherwise BC1
+/// \return Blocks in row order
+std::vector<unsigned char> CompressImage(const unsigned char* rgba, int width, int height, bool withAlpha);
+
+#endif
@@ -0,0 +1,329 @@
+/// Texture baker
+/// Convert images into texture container (.lgt) which lgl::util::LoadBakedTexture() uploads as it is,
+/// see lgl/BakedTexture.h. Each output holds full mipmap chain, already flipped vertically the same as
+/// lgl::util::LoadTexture() does, and optionally block-compressed.
+///
+/// Usage: texturebaker.out [-f auto|rgb|rgba|bc1|bc3] [-v page-size] [-l] [-o output-dir] <image>...
+///
+///     -f  Format of output, default is auto which picks bc3 for images with alpha, otherwise bc1
+///     -v  Write virtual texture page file (.lgv) with pages of page-size texels instead, see
+///         lgl/PagedTexture.h. Pages are always RGBA8, -f is ignored.
+///     -l  Images hold linear data (i.e. normal maps), otherwise they're sRGB and mipmaps are filtered
+///         in linear space
+///     -o  Directory to write output into, default is next to each input
+///
+/// Output has the same name as input with .lgt extension (or .lgv), i.e. to bake all assets
+///     ./texturebaker.out ../../data/*.jpg ../../data/*.png
+#include "lgl/BakedTexture.h"
+#include "lgl/PagedTexture.h"
+#include "lgl/Mipmap.h"
+#define LGL_EXTERNAL_STB_IMAGE_INCLUDE
+#include "lgl/External.h"
+#include "BlockCompress.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// Encode RGBA8 level into output format.
+static std::vector<unsigned char> EncodeLevel(const std::vector<unsigned char>& rgba, int width, int height, std::uint32_t format)
+{
+    switch (format)
+    {
+    case lgl::baked::FORMAT_RGB8:
+    {
+        std::vector<unsigned char> rgb(static_cast<std::size_t>(width) * height * 3);
+        for (std::size_t i=0; i<static_cast<std::size_t>(width) * height; ++i)
+            std::memcpy(&rgb[i * 3], &rgba[i * 4], 3);
+        return rgb;
+    }
+    case lgl::baked::FORMAT_BC1:
+        return CompressImage(rgba.data(), width, height, false);
+    case lgl::baked::FORMAT_BC3:
+        return CompressImage(rgba.data(), width, height, true);
+    default:
+        return rgba;
+    }
+}
+
+static std::string MakeOutputPath(const std::string& inputPath, const char* outputDir, const char* extension)
+{
+    std::string stem = inputPath;
+    const std::size_t dot = stem.find_last_of('.');
+    const std::size_t slash = stem.find_last_of('/');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        stem.erase(dot);
+
+    if (outputDir == nullptr)
+        return stem + extension;
+
+    const std::string name = slash == std::string::npos ? stem : stem.substr(slash + 1);
+    return std::string(outputDir) + "/" + name + extension;
+}
+
+/// Bake an image.
+/// Header structs are written as they are, which matches the little-endian file layout on
+/// little-endian hosts this baker is meant to be run on.
+///
+/// \return 0 for success, otherwise -1
+static int Bake(const char* inputPath, const std::string& outputPath, const char* formatName, bool isSRGB)
+{
+    int width, height, nrChannels;
+    // always expand to RGBA, alpha is dropped later for formats without it
+    unsigned char* pixels = stbi_load(inputPath, &width, &height, &nrChannels, 4);
+    if (pixels == nullptr)
+    {
+        std::fprintf(stderr, "Error loading %s [%s]\n", inputPath, stbi_failure_reason());
+        return -1;
+    }
+
+    const bool hasAlpha = nrChannels == 2 || nrChannels == 4;
+    std::uint32_t format;
+    if (std::strcmp(formatName, "rgb") == 0)
+        format = lgl::baked::FORMAT_RGB8;
+    else if (std::strcmp(formatName, "rgba") == 0)
+        format = lgl::baked::FORMAT_RGBA8;
+    else if (std::strcmp(formatName, "bc1") == 0)
+        format = lgl::baked::FORMAT_BC1;
+    else if (std::strcmp(formatName, "bc3") == 0)
+        format = lgl::baked::FORMAT_BC3;
+    else
+        format = hasAlpha ? lgl::baked::FORMAT_BC3 : lgl::baked::FORMAT_BC1;
+
+    std::vector<unsigned char> level(pixels, pixels + static_cast<std::size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    // full mipmap chain down to 1x1
+    std::vector<lgl::baked::LevelHeader> levelHeaders;
+    std::vector<std::vector<unsigned char>> levelData;
+    int levelWidth = width, levelHeight = height;
+    for (;;)
+    {
+        lgl::baked::LevelHeader header;
+        header.width = static_cast<std::uint32_t>(levelWidth);
+        header.height = static_cast<std::uint32_t>(levelHeight);
+        header.offset = 0;
+        levelData.push_back(EncodeLevel(level, levelWidth, levelHeight, format));
+        header.size = levelData.back().size();
+        levelHeaders.push_back(header);
+
+        if (levelWidth == 1 && levelHeight == 1)
+            break;
+        std::vector<unsigned char> next(static_cast<std::size_t>(std::max(1, levelWidth / 2)) * std::max(1, levelHeight / 2) * 4);
+        lgl::mipmap::Downsample(level.data(), levelWidth, levelHeight, 4, isSRGB, next.data());
+        level.swap(next);
+        levelWidth = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+    }
+
+    lgl::baked::FileHeader fileHeader;
+    std::memcpy(fileHeader.magic, lgl::baked::kMagic, sizeof(fileHeader.magic));
+    fileHeader.version = lgl::baked::kVersion;
+    fileHeader.format = format;
+    fileHeader.width = static_cast<std::uint32_t>(width);
+    fileHeader.height = static_cast<std::uint32_t>(height);
+    fileHeader.numLevels = static_cast<std::uint32_t>(levelHeaders.size());
+
+    const std::uint64_t alignment = lgl::baked::kDataAlignment;
+    std::uint64_t offset = sizeof(fileHeader) + sizeof(lgl::baked::LevelHeader) * levelHeaders.size();
+    for (lgl::baked::LevelHeader& header : levelHeaders)
+    {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        header.offset = offset;
+        offset += header.size;
+    }
+
+    FILE* file = std::fopen(outputPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Error opening %s for writing\n", outputPath.c_str());
+        return -1;
+    }
+
+    std::fwrite(&fileHeader, sizeof(fileHeader), 1, file);
+    std::fwrite(levelHeaders.data(), sizeof(lgl::baked::LevelHeader), levelHeaders.size(), file);
+    const unsigned char padding[lgl::baked::kDataAlignment] = {};
+    std::uint64_t written = sizeof(fileHeader) + sizeof(lgl::baked::LevelHeader) * levelHeaders.size();
+    for (std::size_t i=0; i<levelHeaders.size(); ++i)
+    {
+        std::fwrite(padding, 1, levelHeaders[i].offset - written, file);
+        std::fwrite(levelData[i].data(), 1, levelData[i].size(), file);
+        written = levelHeaders[i].offset + levelHeaders[i].size;
+    }
+
+    const bool isWritten = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!isWritten)
+    {
+        std::fprintf(stderr, "Error writing %s\n", outputPath.c_str());
+        return -1;
+    }
+
+    static const char* const kFormatNames[] = { "", "rgb", "rgba", "bc1", "bc3" };
+    std::printf("%s -> %s (%dx%d, %s, %u levels, %llu bytes)\n", inputPath, outputPath.c_str(), width, height,
+                kFormatNames[format], fileHeader.numLevels, static_cast<unsigned long long>(written));
+    return 0;
+}
+
+/// Bake an image into virtual texture page file.
+/// Level 0 is padded with repeated edge so each level halves exactly, then each page is cut out
+/// along with its border from the level it belongs to.
+///
+/// \return 0 for success, otherwise -1
+static int BakeVirtual(const char* inputPath, const std::string& outputPath, int pageSize, bool isSRGB)
+{
+    int width, height, nrChannels;
+    unsigned char* pixels = stbi_load(inputPath, &width, &height, &nrChannels, 4);
+    if (pixels == nullptr)
+    {
+        std::fprintf(stderr, "Error loading %s [%s]\n", inputPath, stbi_failure_reason());
+        return -1;
+    }
+
+    // levels go down until the shorter side is a single page
+    const int pagesW = (width + pageSize - 1) / pageSize;
+    const int pagesH = (height + pageSize - 1) / pageSize;
+    int numLevels = 1;
+    while ((std::min(pagesW, pagesH) >> numLevels) > 0)
+        ++numLevels;
+    const int multiple = 1 << (numLevels - 1);
+    const int pagesX = (pagesW + multiple - 1) / multiple * multiple;
+    const int pagesY = (pagesH + multiple - 1) / multiple * multiple;
+    if (pagesX > static_cast<int>(lgl::paged::kMaxPages) || pagesY > static_cast<int>(lgl::paged::kMaxPages))
+    {
+        std::fprintf(stderr, "Error baking %s [%dx%d pages exceed %u per side, use larger page size]\n", inputPath, pagesX, pagesY, lgl::paged::kMaxPages);
+        stbi_image_free(pixels);
+        return -1;
+    }
+
+    int levelWidth = pagesX * pageSize;
+    int levelHeight = pagesY * pageSize;
+    std::vector<unsigned char> level(static_cast<std::size_t>(levelWidth) * levelHeight * 4);
+    for (int y=0; y<levelHeight; ++y)
+    {
+        for (int x=0; x<levelWidth; ++x)
+        {
+            const unsigned char* src = pixels + (static_cast<std::size_t>(std::min(y, height - 1)) * width + std::min(x, width - 1)) * 4;
+            std::memcpy(&level[(static_cast<std::size_t>(y) * levelWidth + x) * 4], src, 4);
+        }
+    }
+    stbi_image_free(pixels);
+
+    lgl::paged::FileHeader header;
+    std::memcpy(header.magic, lgl::paged::kMagic, sizeof(header.magic));
+    header.version = lgl::paged::kVersion;
+    header.width = static_cast<std::uint32_t>(width);
+    header.height = static_cast<std::uint32_t>(height);
+    header.pageSize = static_cast<std::uint32_t>(pageSize);
+    // enough for bilinear filtering within a level
+    header.border = 1;
+    header.numLevels = static_cast<std::uint32_t>(numLevels);
+    header.pagesX = static_cast<std::uint32_t>(pagesX);
+    header.pagesY = static_cast<std::uint32_t>(pagesY);
+    header.reserved = 0;
+
+    FILE* file = std::fopen(outputPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Error opening %s for writing\n", outputPath.c_str());
+        return -1;
+    }
+
+    const unsigned char padding[lgl::paged::kDataOffset] = {};
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(padding, 1, lgl::paged::kDataOffset - sizeof(header), file);
+
+    const int border = static_cast<int>(header.border);
+    const int side = pageSize + 2 * border;
+    std::vector<unsigned char> page(static_cast<std::size_t>(side) * side * 4);
+    for (int l=0; l<numLevels; ++l)
+    {
+        for (int py=0; py<(pagesY >> l); ++py)
+        {
+            for (int px=0; px<(pagesX >> l); ++px)
+            {
+                for (int y=0; y<side; ++y)
+                {
+                    const int sy = std::min(std::max(py * pageSize + y - border, 0), levelHeight - 1);
+                    for (int x=0; x<side; ++x)
+                    {
+                        const int sx = std::min(std::max(px * pageSize + x - border, 0), levelWidth - 1);
+                        std::memcpy(&page[(static_cast<std::size_t>(y) * side + x) * 4], &level[(static_cast<std::size_t>(sy) * levelWidth + sx) * 4], 4);
+                    }
+                }
+                std::fwrite(page.data(), 1, page.size(), file);
+            }
+        }
+
+        if (l + 1 < numLevels)
+        {
+            std::vector<unsigned char> next(static_cast<std::size_t>(levelWidth / 2) * (levelHeight / 2) * 4);
+            lgl::mipmap::Downsample(level.data(), levelWidth, levelHeight, 4, isSRGB, next.data());
+            level.swap(next);
+            levelWidth /= 2;
+            levelHeight /= 2;
+        }
+    }
+
+    const bool isWritten = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!isWritten)
+    {
+        std::fprintf(stderr, "Error writing %s\n", outputPath.c_str());
+        return -1;
+    }
+
+    const std::uint32_t numPages = lgl::paged::GetNumPages(header);
+    std::printf("%s -> %s (%dx%d, %dx%d pages of %d, %d levels, %u pages, %llu bytes)\n", inputPath, outputPath.c_str(), width, height,
+                pagesX, pagesY, pageSize, numLevels, numPages,
+                static_cast<unsigned long long>(lgl::paged::kDataOffset + numPages * lgl::paged::GetPageBytes(header)));
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* formatName = "auto";
+    const char* outputDir = nullptr;
+    int pageSize = 0;
+    bool isSRGB = true;
+    std::vector<const char*> inputs;
+    for (int i=1; i<argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+            formatName = argv[++i];
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outputDir = argv[++i];
+        else if (std::strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+            pageSize = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-l") == 0)
+            isSRGB = false;
+        else
+            inputs.push_back(argv[i]);
+    }
+
+    const char* const kFormats[] = { "auto", "rgb", "rgba", "bc1", "bc3" };
+    bool isKnownFormat = false;
+    for (const char* f : kFormats)
+        isKnownFormat = isKnownFormat || std::strcmp(formatName, f) == 0;
+
+    if (inputs.empty() || !isKnownFormat || pageSize < 0)
+    {
+        std::fprintf(stderr, "Usage: %s [-f auto|rgb|rgba|bc1|bc3] [-v page-size] [-l] [-o output-dir] <image>...\n", argv[0]);
+        return 1;
+    }
+
+    // the same orientation as lgl::util::LoadTexture() uploads
+    stbi_set_flip_vertically_on_load(true);
+
+    int numFailed = 0;
+    for (const char* input : inputs)
+    {
+        const int result = pageSize > 0 ? BakeVirtual(input, MakeOutputPath(input, outputDir, ".lgv"), pageSize, isSRGB)
+                                         : Bake(input, MakeOutputPath(input, outputDir, ".lgt"), formatName, isSRGB);
+        if (result != 0)
+            ++numFailed;
+    }
+    return numFailed == 0 ? 0 : 1;
+}
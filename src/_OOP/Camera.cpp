@@ -74,20 +74,15 @@ public:
 
     void UserSetup() override {
         // create shader program and build it immediately
-        int result = basicShader.Build("data/tex2.vert", "data/multitex.frag");
+        int result = basicShader.Build("data/tex.vert", "data/multitex.frag", { "MVP_TRANSFORM" });
         LGL_ERROR_QUIT(result, "Error creating basic shader");
 
-        // load texture
-        containerTexture = lgl::util::LoadTexture("data/container.jpg");
-        if (lgl::error::AnyGLError() != 0) { lgl::error::ErrorExit("Error loading data/container.jpg"); }
-        // modify its texture filtering
-        glBindTexture(GL_TEXTURE_2D, containerTexture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        // load textures via shared cache, as they're shared filter container via sampler object instead
+        containerTexture = lgl::TextureCache::Acquire("data/container.jpg");
+        if (containerTexture == 0) { lgl::error::ErrorExit("Error loading data/container.jpg"); }
         
-        awesomefaceTexture = lgl::util::LoadTexture("data/awesomeface.png");
-        if (lgl::error::AnyGLError() != 0) { lgl::error::ErrorExit("Error loading data/awesomeface.png"); }
+        awesomefaceTexture = lgl::TextureCache::Acquire("data/awesomeface.png");
+        if (awesomefaceTexture == 0) { lgl::error::ErrorExit("Error loading data/awesomeface.png"); }
 
         // wrap vertex attrib configurations via VAO
         glGenVertexArrays(1, &VAO);
@@ -103,17 +98,15 @@ public:
             // texture coords
             glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));  // start after 3 floats
             glEnableVertexAttribArray(1);
-
-            // bind texture
-            glBindTexture(GL_TEXTURE_2D, containerTexture);
         glBindVertexArray(0);
 
+        // overrides parameters of whichever texture is bound to unit 0
+        lgl::TextureUnits::BindSampler(0, lgl::Sampler::Get(lgl::TextureSampling(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_NEAREST)));
+
         // once preparation
         // tell opengl which texture sampler map to whichs texture object
         basicShader.Use();
-        glActiveTexture(GL_TEXTURE0);
         basicShader.SetUniform(basicShader.GetUniformLocation("textureSampler"), 0);
-        glActiveTexture(GL_TEXTURE1);
         basicShader.SetUniform(basicShader.GetUniformLocation("textureSampler2"), 1);
         // set default uniform values
         basicShader.SetUniform(basicShader.GetUniformLocation("mixFactor"), mixFactor);
@@ -153,7 +146,8 @@ public:
             basicShader.SetUniform("mixFactor", mixFactor);
         }
 
-        // camera movement
+        // camera movement, called once per fixed update step so keep where it was for interpolation
+        prevCamPos = camPos;
         const float kCamSpeed = 2.5f * deltaTime;
         if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
             camPos += kCamSpeed * camFront;
@@ -206,11 +200,13 @@ public:
         // delete all VBOs
         glDeleteBuffers(1, &VBO);
         VBO = -1;
-        // reset texture binding to default texture
-        glBindTexture(GL_TEXTURE_2D, 0);
-        // delete all textures
-        glDeleteTextures(1, &containerTexture);
-        containerTexture = -1;
+        // release all textures back to cache, and delete samplers
+        lgl::TextureCache::Release(containerTexture);
+        lgl::TextureCache::Release(awesomefaceTexture);
+        lgl::TextureCache::Clear();
+        containerTexture = 0;
+        awesomefaceTexture = 0;
+        lgl::Sampler::Clear();
         // delete shader program
         basicShader.Destroy();
         // delete all VAOs
@@ -218,21 +214,22 @@ public:
         VAO = -1;
     }
 
-    void UserRender() override {
+    void UserRenderInterpolated(double alpha) override {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
         basicShader.Use();
-        // bind texture 0
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, containerTexture);
-        // bind texture 1
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, awesomefaceTexture);
+        // bind textures, skipped when they are still bound from previous frame
+        lgl::TextureUnits::BindTexture(0, containerTexture);
+        lgl::TextureUnits::BindTexture(1, awesomefaceTexture);
 
         glBindVertexArray(VAO);
 
-        glm::mat4 view = glm::lookAt(camPos, camPos + camFront, camUp);
+        // draw in between the last two fixed updates, so motion is smooth at any frame rate
+        const glm::vec3 renderCamPos = glm::mix(prevCamPos, camPos, static_cast<float>(alpha));
+        const float renderTime = static_cast<float>(prevSimTime + (simTime - prevSimTime) * alpha);
+
+        glm::mat4 view = glm::lookAt(renderCamPos, renderCamPos + camFront, camUp);
         glUniformMatrix4fv(basicShader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
 
         for (std::size_t i=0; i<10; ++i)
@@ -241,7 +238,7 @@ public:
 
             float angle = 35.0f * i + 20.0f;
             if (i % 3 == 0)
-                model = glm::rotate(model, static_cast<float>(glfwGetTime()) * glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+                model = glm::rotate(model, renderTime * glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
             else
                 model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
             glUniformMatrix4fv(basicShader.GetUniformLocation("model"), 1, GL_FALSE, glm::value_ptr(model));
@@ -254,6 +251,9 @@ public:
 
     void UserUpdate(const double delta) override
     {
+        // simulated time advances by the same steps on every machine
+        prevSimTime = simTime;
+        simTime += delta;
     }
 
 private:
@@ -264,12 +264,16 @@ private:
     GLuint VAO;
     
     glm::vec3 camPos = glm::vec3(0.0f, 0.0f, 3.0f);
+    glm::vec3 prevCamPos = camPos;
     glm::vec3 camFront = glm::vec3(0.0f, 0.0f, -1.0f);
     glm::vec3 camUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
     // camera looks into -z axis, the following values make sure initial values and conditions are met
     float camYaw = -90.0f, camPitch = 0.0f;
     float camFov = 45.0f;
+
+    double simTime = 0.0;
+    double prevSimTime = 0.0;
 };
 
 int main()
@@ -280,6 +284,8 @@ int main()
     configs.MousePosEnabled = true;
     configs.RelativeMouseCursor = true;
     configs.MouseScrollEnabled = true;
+    // simulate at 60 Hz, render interpolates in between
+    configs.FixedUpdateHz = 60.0;
 
     app.Setup("Camera", configs);
     app.Start();
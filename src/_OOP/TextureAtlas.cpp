@@ -0,0 +1,165 @@
+/*
+====================
+Draw many quads each textured by different image with a single draw call per atlas page
+via lgl::TextureAtlas, instead of binding texture of each image.
+
+Images are the ones in data/ plus generated checkerboards, packed into 2048x2048 pages.
+====================
+*/
+#include "lgl/Base.h"
+#include <algorithm>
+#include <cstdlib>
+
+#define NUM_COLUMNS 24
+#define NUM_ROWS 16
+#define NUM_CHECKERBOARDS 64
+
+static const char* const kVertexShaderStr = R"(#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+out vec2 vsTexCoord;
+void main()
+{
+    gl_Position = vec4(aPos, 0.0, 1.0);
+    vsTexCoord = aTexCoord;
+})";
+
+static const char* const kFragmentShaderStr = R"(#version 330 core
+uniform sampler2D textureSampler;
+in vec2 vsTexCoord;
+out vec4 fsColor;
+void main()
+{
+    fsColor = texture(textureSampler, vsTexCoord);
+})";
+
+class Demo : public lgl::App
+{
+public:
+    void UserSetup() override {
+        int result = shader.BuildFromSrc(kVertexShaderStr, kFragmentShaderStr);
+        LGL_ERROR_QUIT(result, "Error creating shader");
+        shader.Use();
+        shader.SetUniform("textureSampler", 0);
+
+        // queue images into atlas
+        atlas.Create();
+        std::vector<int> ids;
+        const char* filepaths[] = { "data/container.jpg", "data/awesomeface.png", "data/wall.jpg" };
+        for (const char* filepath : filepaths)
+        {
+            const int id = atlas.Add(filepath);
+            if (id == LGL_FAIL)
+                lgl::error::ErrorExit("Error loading image into atlas");
+            ids.push_back(id);
+        }
+        for (int i=0; i<NUM_CHECKERBOARDS; ++i)
+            ids.push_back(AddCheckerboard(16 + (i % 4) * 16));
+
+        result = atlas.Build();
+        LGL_ERROR_QUIT(result, "Error building texture atlas");
+
+        // quads of the same page are next to each other, so each page is drawn with a single call
+        std::vector<GLfloat> vertices;
+        pageFirstVertex.assign(atlas.GetNumPages() + 1, 0);
+        for (int page=0; page<atlas.GetNumPages(); ++page)
+        {
+            pageFirstVertex[page] = static_cast<GLint>(vertices.size() / 4);
+            for (int i=0; i<NUM_COLUMNS * NUM_ROWS; ++i)
+            {
+                const lgl::AtlasRect& rect = atlas.GetRect(ids[i % ids.size()]);
+                if (rect.page == page)
+                    AppendQuad(i % NUM_COLUMNS, i / NUM_COLUMNS, rect, vertices);
+            }
+        }
+        pageFirstVertex[atlas.GetNumPages()] = static_cast<GLint>(vertices.size() / 4);
+
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+            glGenBuffers(1, &VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (static_cast<char*>(0) + 2 * sizeof(GLfloat)));
+            glEnableVertexAttribArray(0);
+            glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+
+        std::cout << "Images: " << atlas.GetNumImages() << ", pages: " << atlas.GetNumPages()
+                  << ", quads: " << NUM_COLUMNS * NUM_ROWS << ", draw calls per frame: " << atlas.GetNumPages() << '\n';
+    }
+
+    void UserShutdown() override {
+        glDeleteBuffers(1, &VBO);
+        glDeleteVertexArrays(1, &VAO);
+        atlas.Destroy();
+        shader.Destroy();
+    }
+
+    void UserRender() override {
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        shader.Use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(VAO);
+        for (int page=0; page<atlas.GetNumPages(); ++page)
+        {
+            glBindTexture(GL_TEXTURE_2D, atlas.GetTexture(page));
+            glDrawArrays(GL_TRIANGLES, pageFirstVertex[page], pageFirstVertex[page + 1] - pageFirstVertex[page]);
+        }
+        glBindVertexArray(0);
+    }
+
+private:
+    lgl::Shader shader;
+    lgl::TextureAtlas atlas;
+    std::vector<GLint> pageFirstVertex;     // one more than number of pages, the last one marks the end
+    GLuint VBO;
+    GLuint VAO;
+
+    /// Add checkerboard of random colors into atlas
+    int AddCheckerboard(int size) {
+        const unsigned char a[3] = { static_cast<unsigned char>(std::rand()), static_cast<unsigned char>(std::rand()), static_cast<unsigned char>(std::rand()) };
+        const unsigned char b[3] = { static_cast<unsigned char>(255 - a[0]), static_cast<unsigned char>(255 - a[1]), static_cast<unsigned char>(255 - a[2]) };
+        std::vector<unsigned char> pixels(size * size * 3);
+        for (int y=0; y<size; ++y)
+        {
+            for (int x=0; x<size; ++x)
+            {
+                const unsigned char* color = ((x / 8 + y / 8) % 2 == 0) ? a : b;
+                std::copy(color, color + 3, &pixels[(y * size + x) * 3]);
+            }
+        }
+        return atlas.Add(pixels.data(), size, size, 3);
+    }
+
+    /// Append 2 triangles of quad at cell of grid covering the whole screen
+    static void AppendQuad(int column, int row, const lgl::AtlasRect& rect, std::vector<GLfloat>& vertices) {
+        const float cellWidth = 2.0f / NUM_COLUMNS;
+        const float cellHeight = 2.0f / NUM_ROWS;
+        // leave small space between quads
+        const float x0 = -1.0f + column * cellWidth + cellWidth * 0.05f;
+        const float y0 = -1.0f + row * cellHeight + cellHeight * 0.05f;
+        const float x1 = x0 + cellWidth * 0.9f;
+        const float y1 = y0 + cellHeight * 0.9f;
+
+        const GLfloat quad[] = {
+            x0, y0, rect.u0, rect.v0,
+            x1, y0, rect.u1, rect.v0,
+            x1, y1, rect.u1, rect.v1,
+            x0, y0, rect.u0, rect.v0,
+            x1, y1, rect.u1, rect.v1,
+            x0, y1, rect.u0, rect.v1
+        };
+        vertices.insert(vertices.end(), quad, quad + sizeof(quad) / sizeof(quad[0]));
+    }
+};
+
+int main()
+{
+    Demo app;
+    app.Setup("Texture atlas");
+    app.Start();
+    return 0;
+}
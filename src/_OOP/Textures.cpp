@@ -7,10 +7,18 @@ Changes
 - updated to use with proper shader sources (now tex.vert/frag)
 - fully and properly clean up memory used by this program, see UserShutdown()
 - mix color between two textures in GLSL, set its mixFactor via uniform, texture filtering config
+- build shader asynchronously while loading textures, see Shader::BuildAsync()
+- load textures asynchronously, see lgl::TextureLoader
+- hot-reload shader when data/tex.vert or data/multitex.frag is changed, see lgl::ShaderWatcher
+- read assets from data.lgp packed by src/AssetPacker if it exists, see lgl::vfs
+- filter container texture via shared sampler object, and skip redundant binds, see lgl::Sampler and lgl::TextureUnits
+- create debug context and print OpenGL errors once per frame, see lgl::DebugOutput
+- render only when something changed, at most 60 frames per second, see lgl::AppConfigs::IdleWhenUnchanged
 ====================
 */
 #include "lgl/Base.h"
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 
 float vertices[] = {
@@ -30,20 +38,27 @@ class Demo : public lgl::App
 {
 public:
     void UserSetup() override {
-        // create shader program and build it immediately
-        int result = basicShader.Build("data/tex.vert", "data/multitex.frag");
+        // one archive instead of opening each file, paths stay the same
+        if (lgl::vfs::Exists("data.lgp"))
+            lgl::vfs::MountArchive("data.lgp", "data");
+
+        // start building shader program, driver compiles it while we load textures and mesh below
+        int result = basicShader.BuildAsync("data/tex.vert", "data/multitex.frag");
         LGL_ERROR_QUIT(result, "Error creating basic shader");
 
-        // load texture
-        containerTexture = lgl::util::LoadTexture("data/container.jpg");
+        // load textures on worker threads, they show placeholder until uploaded in UserUpdate()
+        textureLoader.Start();
+        // falls back to upload from client memory if pixel buffers cannot be created
+        textureLoader.EnablePixelBufferStreaming();
+        // gamma-correct mipmaps built on worker threads
+        textureLoader.EnableCpuMipmaps();
+        containerTexture = textureLoader.Load("data/container.jpg");
         if (lgl::error::AnyGLError() != 0) { lgl::error::ErrorExit("Error loading data/container.jpg"); }
-        // modify its texture filtering
-        glBindTexture(GL_TEXTURE_2D, containerTexture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        
-        awesomefaceTexture = lgl::util::LoadTexture("data/awesomeface.png");
+        // modify its texture filtering via sampler object bound to its unit instead of texture itself
+        lgl::TextureUnits::BindSampler(0, lgl::Sampler::Get(lgl::TextureSampling(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_NEAREST)));
+
+
+        awesomefaceTexture = textureLoader.Load("data/awesomeface.png");
         if (lgl::error::AnyGLError() != 0) { lgl::error::ErrorExit("Error loading data/awesomeface.png"); }
 
         // wrap vertex attrib configurations via VAO
@@ -61,27 +76,39 @@ public:
             glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));  // start after 3 floats
             glEnableVertexAttribArray(1);
 
-            // bind texture
-            glBindTexture(GL_TEXTURE_2D, containerTexture);
-
             // prepare of EBO (Element Buffer Object) for indexed drawing
             glGenBuffers(1, &EBO);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
         glBindVertexArray(0);
 
+        // wait for shader program to be built before using it
+        result = basicShader.FinishBuild();
+        LGL_ERROR_QUIT(result, "Error creating basic shader");
+
         // once preparation
         // tell opengl which texture sampler map to whichs texture object
         basicShader.Use();
-        glActiveTexture(GL_TEXTURE0);
         basicShader.SetUniform("textureSampler", 0);
-        glActiveTexture(GL_TEXTURE1);
         basicShader.SetUniform("textureSampler2", 1);
         // set default uniform values
         basicShader.SetUniform("mixFactor", mixFactor);
         
         // set matrix identity to transform 
-        glUniformMatrix4fv(basicShader.GetUniformLocation("transform"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+        basicShader.SetUniform(basicShader.GetUniformLocation("transform"), glm::mat4(1.0f));
+
+        // rebuild shader whenever its files are changed, values set above are carried over
+        shaderWatcher.Watch(basicShader, "data/tex.vert", "data/multitex.frag");
+        shaderWatcher.Start();
+    }
+
+    void UserUpdate(double delta) override {
+        // redraw only when shader or textures changed, App sleeps otherwise
+        if (shaderWatcher.Poll() > 0)
+            RequestRedraw();
+        // upload decoded textures for at most 2 ms per frame
+        if (textureLoader.Update(0.002) > 0)
+            RequestRedraw();
     }
 
     void UserProcessKeyInput(double delta) override {
@@ -120,12 +147,25 @@ public:
         // delete all EBO (index buffer)
         glDeleteBuffers(1, &EBO);
         EBO = -1;
-        // reset texture binding to default texture
-        glBindTexture(GL_TEXTURE_2D, 0);
-        // delete all textures
+        // report how many frames were rendered and how long main loop was at rest
+        const lgl::FrameStats frameStats = GetFrameStats();
+        std::printf("Frames: %llu rendered, %llu skipped, %.2f s idle, %.2f s sleeping, %.3f s spinning\n",
+                    frameStats.framesRendered, frameStats.framesSkipped, frameStats.secondsIdle, frameStats.secondsSleeping, frameStats.secondsSpinning);
+        // report how many binds were skipped
+        const lgl::TextureBindStats& bindStats = lgl::TextureUnits::GetStats();
+        std::printf("Texture binds: %u issued, %u skipped, unit switches: %u issued, %u skipped\n",
+                    bindStats.bindsIssued, bindStats.bindsSkipped, bindStats.unitSwitchesIssued, bindStats.unitSwitchesSkipped);
+        // delete all textures and samplers
+        textureLoader.Stop();
+        lgl::TextureUnits::ForgetTexture(containerTexture);
         glDeleteTextures(1, &containerTexture);
         containerTexture = -1;
+        lgl::TextureUnits::ForgetTexture(awesomefaceTexture);
+        glDeleteTextures(1, &awesomefaceTexture);
+        awesomefaceTexture = -1;
+        lgl::Sampler::Clear();
         // delete shader program
+        shaderWatcher.Stop();
         basicShader.Destroy();
         // delete all VAOs
         glDeleteVertexArrays(1, &VAO);
@@ -137,12 +177,9 @@ public:
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
         basicShader.Use();
-        // bind texture 0
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, containerTexture);
-        // bind texture 1
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, awesomefaceTexture);
+        // bind textures, skipped when they are still bound from previous frame
+        lgl::TextureUnits::BindTexture(0, containerTexture);
+        lgl::TextureUnits::BindTexture(1, awesomefaceTexture);
 
         glBindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
@@ -151,6 +188,8 @@ public:
 
 private:
     lgl::Shader basicShader;
+    lgl::ShaderWatcher shaderWatcher;
+    lgl::TextureLoader textureLoader;
     GLuint containerTexture, awesomefaceTexture;
     GLfloat mixFactor = 0.2f;
     GLuint EBO;
@@ -161,7 +200,13 @@ private:
 int main()
 {
     Demo app;
-    app.Setup("Textures");
+    lgl::AppConfigs configs;
+    // driver reports errors via debug output instead of polling glGetError() after each call
+    configs.DebugContext = true;
+    // static image, render only when something changed and at most 60 frames per second
+    configs.IdleWhenUnchanged = true;
+    configs.TargetFps = 60.0;
+    app.Setup("Textures", configs);
     app.Start();
     return 0;
 }
@@ -79,7 +79,7 @@ public:
 
     void UserSetup() override {
         // create shader program and build it immediately
-        int result = basicShader.Build("data/tex2.vert", "data/multitex.frag");
+        int result = basicShader.Build("data/tex.vert", "data/multitex.frag", { "MVP_TRANSFORM" });
         LGL_ERROR_QUIT(result, "Error creating basic shader");
 
         // load texture
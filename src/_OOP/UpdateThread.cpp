@@ -0,0 +1,253 @@
+/*
+====================
+Cubes bouncing off each other inside a box, simulated on update thread while main thread renders.
+
+Each update step tests every pair of cubes, then publishes positions before and after the step as
+an immutable snapshot via lgl::SnapshotBuffer. Render acquires the latest one and interpolates it
+by lgl::App::GetRenderAlpha(), so it never waits for simulation nor sees it half way through.
+
+Run with "single" as argument to update on main thread instead and compare frame rate, with
+vsync off it's printed on exit.
+====================
+*/
+#include "lgl/Base.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+float vertices[] = {
+    // positions          // texture coords
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+static const int kNumCubes = 256;
+static const float kCubeScale = 0.3f;
+// cubes collide as spheres of this radius
+static const float kRadius = kCubeScale * 0.5f;
+// half extent of box they bounce in
+static const float kBoxHalf = 3.0f;
+
+// state handed from update thread to render, written as a whole every step
+struct Snapshot
+{
+    double time;                        // time simulation reached, see lgl::App::GetUpdateTime()
+    glm::vec3 prevPositions[kNumCubes];
+    glm::vec3 positions[kNumCubes];
+};
+
+class Demo : public lgl::App
+{
+public:
+    Demo() : App()
+    {
+    }
+
+    void UserSetup() override {
+        // create shader program and build it immediately
+        int result = basicShader.Build("data/tex.vert", "data/multitex.frag", { "MVP_TRANSFORM" });
+        LGL_ERROR_QUIT(result, "Error creating basic shader");
+
+        containerTexture = lgl::TextureCache::Acquire("data/container.jpg");
+        if (containerTexture == 0) { lgl::error::ErrorExit("Error loading data/container.jpg"); }
+
+        awesomefaceTexture = lgl::TextureCache::Acquire("data/awesomeface.png");
+        if (awesomefaceTexture == 0) { lgl::error::ErrorExit("Error loading data/awesomeface.png"); }
+
+        // wrap vertex attrib configurations via VAO
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+            // prepare vertex data
+            glGenBuffers(1, &VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+            // positions
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(0));
+            glEnableVertexAttribArray(0);
+            // texture coords
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+
+        basicShader.Use();
+        basicShader.SetUniform(basicShader.GetUniformLocation("textureSampler"), 0);
+        basicShader.SetUniform(basicShader.GetUniformLocation("textureSampler2"), 1);
+        basicShader.SetUniform(basicShader.GetUniformLocation("mixFactor"), 0.2f);
+
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, 9.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glUniformMatrix4fv(basicShader.GetUniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), SCREEN_WIDTH * 1.0f / SCREEN_HEIGHT, 0.1f, 100.0f);
+        glUniformMatrix4fv(basicShader.GetUniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        modelLocation = basicShader.GetUniformLocation("model");
+
+        glEnable(GL_DEPTH_TEST);
+
+        // scatter cubes on a grid so none overlaps at start, with random velocity
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> speed(-2.0f, 2.0f);
+        for (int i=0; i<kNumCubes; ++i)
+        {
+            positions[i] = glm::vec3((i % 8) - 3.5f, ((i / 8) % 8) - 3.5f, (i / 64) - 1.5f) * 0.7f;
+            velocities[i] = glm::vec3(speed(rng), speed(rng), speed(rng));
+        }
+    }
+
+    void UserUpdate(const double delta) override
+    {
+        // runs on update thread, no OpenGL here
+        Snapshot& snapshot = snapshots.BeginWrite();
+        std::memcpy(snapshot.prevPositions, positions, sizeof(positions));
+
+        const float dt = static_cast<float>(delta);
+        for (int i=0; i<kNumCubes; ++i)
+        {
+            positions[i] += velocities[i] * dt;
+            // bounce off walls
+            for (int axis=0; axis<3; ++axis)
+            {
+                if (std::fabs(positions[i][axis]) > kBoxHalf - kRadius)
+                {
+                    positions[i][axis] = glm::sign(positions[i][axis]) * (kBoxHalf - kRadius);
+                    velocities[i][axis] = -velocities[i][axis];
+                }
+            }
+        }
+
+        // test every pair, swap velocity along line between centers of those approaching each other
+        for (int i=0; i<kNumCubes; ++i)
+        {
+            for (int j=i+1; j<kNumCubes; ++j)
+            {
+                const glm::vec3 d = positions[j] - positions[i];
+                const float distSq = glm::dot(d, d);
+                if (distSq >= 4.0f * kRadius * kRadius || distSq == 0.0f)
+                    continue;
+                const glm::vec3 n = d / std::sqrt(distSq);
+                const float approach = glm::dot(velocities[i] - velocities[j], n);
+                if (approach > 0.0f)
+                {
+                    velocities[i] -= approach * n;
+                    velocities[j] += approach * n;
+                }
+            }
+        }
+
+        std::memcpy(snapshot.positions, positions, sizeof(positions));
+        snapshot.time = GetUpdateTime();
+        snapshots.Publish();
+    }
+
+    void UserRender() override {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+        const Snapshot* snapshot = snapshots.Acquire();
+        if (snapshot == nullptr)
+            return;
+
+        basicShader.Use();
+        lgl::TextureUnits::BindTexture(0, containerTexture);
+        lgl::TextureUnits::BindTexture(1, awesomefaceTexture);
+        glBindVertexArray(VAO);
+
+        // in between the last step and the one before it, by how far now is past that step
+        const float alpha = static_cast<float>(GetRenderAlpha(snapshot->time));
+        for (int i=0; i<kNumCubes; ++i)
+        {
+            const glm::vec3 position = glm::mix(snapshot->prevPositions[i], snapshot->positions[i], alpha);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+            model = glm::scale(model, glm::vec3(kCubeScale));
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+
+        glBindVertexArray(0);
+    }
+
+    void UserShutdown() override {
+        const lgl::FrameStats frameStats = GetFrameStats();
+        std::printf("Frames: %llu rendered, %.1f fps\n", frameStats.framesRendered, frameStats.framesRendered / glfwGetTime());
+
+        glDisableVertexAttribArray(0);
+        glDisableVertexAttribArray(1);
+        glDeleteBuffers(1, &VBO);
+        VBO = -1;
+        lgl::TextureCache::Release(containerTexture);
+        lgl::TextureCache::Release(awesomefaceTexture);
+        lgl::TextureCache::Clear();
+        containerTexture = 0;
+        awesomefaceTexture = 0;
+        basicShader.Destroy();
+        glDeleteVertexArrays(1, &VAO);
+        VAO = -1;
+    }
+
+private:
+    lgl::Shader basicShader;
+    GLint modelLocation;
+    GLuint containerTexture, awesomefaceTexture;
+    GLuint VBO;
+    GLuint VAO;
+
+    // owned by whichever thread calls UserUpdate()
+    glm::vec3 positions[kNumCubes];
+    glm::vec3 velocities[kNumCubes];
+
+    lgl::SnapshotBuffer<Snapshot> snapshots;
+};
+
+int main(int argc, char** argv)
+{
+    Demo app;
+
+    lgl::AppConfigs configs;
+    configs.FixedUpdateHz = 60.0;
+    configs.UpdateThread = !(argc > 1 && std::strcmp(argv[1], "single") == 0);
+    // render as fast as possible to show how much update costs main thread
+    configs.SwapInterval = 0;
+
+    app.Setup("Update thread", configs);
+    app.Start();
+    return 0;
+}
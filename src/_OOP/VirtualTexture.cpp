@@ -0,0 +1,133 @@
+/*
+====================
+Fly low over a ground plane textured by lgl::VirtualTexture, so only pages seen on screen are
+streamed into a fixed-size physical cache regardless of size of image.
+
+Bake page file first with src/TextureBaker, i.e.
+    ./texturebaker.out -v 128 -o ../../data ../../data/wall.jpg
+then run with its path as argument, default is data/wall.lgv. Large images show it best.
+====================
+*/
+#include "lgl/Base.h"
+#include <cmath>
+
+// ground plane in xz, texture coordinates cover the whole image once
+float vertices[] = {
+    // positions             // texture coords
+    -50.0f, 0.0f,  50.0f,    0.0f, 0.0f,
+     50.0f, 0.0f,  50.0f,    1.0f, 0.0f,
+     50.0f, 0.0f, -50.0f,    1.0f, 1.0f,
+    -50.0f, 0.0f,  50.0f,    0.0f, 0.0f,
+     50.0f, 0.0f, -50.0f,    1.0f, 1.0f,
+    -50.0f, 0.0f, -50.0f,    0.0f, 1.0f
+};
+
+class Demo : public lgl::App
+{
+public:
+    explicit Demo(const char* filepath): filepath(filepath), elapsed(0.0), statsElapsed(0.0)
+    {
+    }
+
+    void UserSetup() override {
+        int result = shader.Build("data/tex.vert", "data/vt.frag", { "MVP_TRANSFORM" });
+        LGL_ERROR_QUIT(result, "Error creating virtual texture shader");
+        result = feedbackShader.Build("data/tex.vert", "data/vt_feedback.frag", { "MVP_TRANSFORM" });
+        LGL_ERROR_QUIT(result, "Error creating feedback shader");
+
+        // feedback at 1/8 of window resolution is enough to tell which pages are seen
+        result = virtualTexture.Create(filepath, 16, SCREEN_WIDTH / 8, SCREEN_HEIGHT / 8);
+        LGL_ERROR_QUIT(result, "Error creating virtual texture");
+
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+            glGenBuffers(1, &VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(0));
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+
+        const glm::mat4 model(1.0f);
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), SCREEN_WIDTH * 1.0f / SCREEN_HEIGHT, 0.1f, 200.0f);
+        for (lgl::Shader* s : { &shader, &feedbackShader })
+        {
+            s->Use();
+            s->SetUniform(s->GetUniformLocation("model"), model);
+            s->SetUniform(s->GetUniformLocation("projection"), projection);
+        }
+
+        glEnable(GL_DEPTH_TEST);
+
+        std::cout << "Virtual texture " << virtualTexture.GetWidth() << "x" << virtualTexture.GetHeight() << '\n';
+    }
+
+    void UserShutdown() override {
+        glDeleteBuffers(1, &VBO);
+        glDeleteVertexArrays(1, &VAO);
+        virtualTexture.Destroy();
+        feedbackShader.Destroy();
+        shader.Destroy();
+    }
+
+    void UserUpdate(const double delta) override {
+        elapsed += delta;
+
+        // circle low over the plane looking ahead and down
+        const float angle = static_cast<float>(elapsed) * 0.1f;
+        const glm::vec3 camPos(std::cos(angle) * 30.0f, 2.0f, std::sin(angle) * 30.0f);
+        const glm::vec3 camTarget(std::cos(angle + 0.3f) * 30.0f, 0.0f, std::sin(angle + 0.3f) * 30.0f);
+        view = glm::lookAt(camPos, camTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        statsElapsed += delta;
+        if (statsElapsed >= 1.0)
+        {
+            const lgl::VirtualTextureStats& stats = virtualTexture.GetStats();
+            std::cout << "Pages requested: " << stats.requested << ", missing: " << stats.missing << ", resident: " << stats.resident
+                      << ", uploaded: " << stats.uploaded << ", evicted: " << stats.evicted << '\n';
+            statsElapsed = 0.0;
+        }
+    }
+
+    void UserRender() override {
+        // low resolution pass telling which pages are needed, read back a frame or two later
+        virtualTexture.BeginFeedback();
+        feedbackShader.Use();
+        feedbackShader.SetUniform(feedbackShader.GetUniformLocation("view"), view);
+        virtualTexture.BindFeedback(feedbackShader);
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        virtualTexture.EndFeedback();
+
+        virtualTexture.Update();
+
+        glClearColor(0.5f, 0.7f, 0.9f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.Use();
+        shader.SetUniform(shader.GetUniformLocation("view"), view);
+        virtualTexture.Bind(shader);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+    }
+
+private:
+    const char* filepath;
+    lgl::Shader shader;
+    lgl::Shader feedbackShader;
+    lgl::VirtualTexture virtualTexture;
+    glm::mat4 view;
+    double elapsed;
+    double statsElapsed;
+    GLuint VBO;
+    GLuint VAO;
+};
+
+int main(int argc, char* argv[])
+{
+    Demo app(argc > 1 ? argv[1] : "data/wall.lgv");
+    app.Setup("Virtual texture");
+    app.Start();
+    return 0;
+}
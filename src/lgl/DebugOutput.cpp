@@ -0,0 +1,197 @@
+#include "lgl/DebugOutput.h"
+#include "lgl/SpscRing.h"
+#include "lgl/Error.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+using namespace lgl;
+
+namespace
+{
+
+struct Message
+{
+    GLenum source;
+    GLenum type;
+    GLenum severity;
+    GLuint id;
+    char text[DebugOutput::kMaxMessageLength];
+};
+
+const char* GetSourceName(GLenum source)
+{
+    switch (source)
+    {
+        case GL_DEBUG_SOURCE_API: return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "Window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY: return "Third party";
+        case GL_DEBUG_SOURCE_APPLICATION: return "Application";
+        default: return "Other";
+    }
+}
+
+const char* GetTypeName(GLenum type)
+{
+    switch (type)
+    {
+        case GL_DEBUG_TYPE_ERROR: return "Error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "Undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY: return "Portability";
+        case GL_DEBUG_TYPE_PERFORMANCE: return "Performance";
+        case GL_DEBUG_TYPE_MARKER: return "Marker";
+        default: return "Other";
+    }
+}
+
+const char* GetSeverityName(GLenum severity)
+{
+    switch (severity)
+    {
+        case GL_DEBUG_SEVERITY_HIGH: return "High";
+        case GL_DEBUG_SEVERITY_MEDIUM: return "Medium";
+        case GL_DEBUG_SEVERITY_LOW: return "Low";
+        default: return "Notification";
+    }
+}
+
+// from most to least severe
+const GLenum kSeverities[] = { GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION };
+
+SpscRing<Message, DebugOutput::kRingCapacity> ring;
+// driver may call back from several of its threads at once, they take turns to be the single producer
+std::atomic_flag producerLock = ATOMIC_FLAG_INIT;
+std::atomic<unsigned int> numReceived(0);
+std::atomic<unsigned int> numDropped(0);
+unsigned int numDrained = 0;
+unsigned int numDroppedReported = 0;
+bool isEnabled = false;
+
+}
+
+int DebugOutput::Enable(GLenum minSeverity, bool synchronous)
+{
+    const GLenum* minIt = std::find(kSeverities, kSeverities + 4, minSeverity);
+    if (minIt == kSeverities + 4)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("0x%x is not a debug message severity", minSeverity);
+#endif
+        return LGL_FAIL;
+    }
+
+    if (!ext::HasDebugOutput())
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("GL_KHR_debug is not supported, keep polling glGetError()");
+#endif
+        return LGL_FAIL;
+    }
+
+    ext::DebugMessageCallback(DebugOutput::Callback, nullptr);
+    Filter(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, true);
+    for (const GLenum* it = minIt + 1; it < kSeverities + 4; ++it)
+        Filter(GL_DONT_CARE, GL_DONT_CARE, *it, false);
+
+    glEnable(GL_DEBUG_OUTPUT);
+    if (synchronous)
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    isEnabled = true;
+
+    // only debug context is required to report every error
+    GLint contextFlags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &contextFlags);
+    lgl::error::SetDebugOutputEnabled((contextFlags & GL_CONTEXT_FLAG_DEBUG_BIT) != 0);
+
+    return LGL_SUCCESS;
+}
+
+void DebugOutput::Disable()
+{
+    if (!isEnabled)
+        return;
+
+    glDisable(GL_DEBUG_OUTPUT);
+    ext::DebugMessageCallback(nullptr, nullptr);
+    isEnabled = false;
+    lgl::error::SetDebugOutputEnabled(false);
+
+    Drain();
+}
+
+bool DebugOutput::IsEnabled()
+{
+    return isEnabled;
+}
+
+void DebugOutput::Filter(GLenum source, GLenum type, GLenum severity, bool enabled)
+{
+    if (ext::DebugMessageControl != nullptr)
+        ext::DebugMessageControl(source, type, severity, 0, nullptr, enabled ? GL_TRUE : GL_FALSE);
+}
+
+unsigned int DebugOutput::Drain()
+{
+    unsigned int numPrinted = 0;
+    Message message;
+    while (ring.TryPop(message))
+    {
+#ifndef LGL_NODEBUG
+        // errors are never rate-limited, distinct ones often share the same format
+        if (message.type == GL_DEBUG_TYPE_ERROR || message.severity == GL_DEBUG_SEVERITY_HIGH)
+            lgl::error::ErrorPrint("GL debug output [%s, %s, %s] %u: %s", GetSourceName(message.source), GetTypeName(message.type),
+                                   GetSeverityName(message.severity), message.id, message.text);
+        else
+            lgl::error::ErrorWarn("GL debug output [%s, %s, %s] %u: %s", GetSourceName(message.source), GetTypeName(message.type),
+                                  GetSeverityName(message.severity), message.id, message.text);
+#endif
+        ++numPrinted;
+    }
+    numDrained += numPrinted;
+
+    const unsigned int dropped = numDropped.load(std::memory_order_relaxed);
+    if (dropped != numDroppedReported)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("%u GL debug output messages were dropped as ring is full", dropped - numDroppedReported);
+#endif
+        numDroppedReported = dropped;
+    }
+
+    return numPrinted;
+}
+
+DebugOutputStats DebugOutput::GetStats()
+{
+    DebugOutputStats stats;
+    stats.received = numReceived.load(std::memory_order_relaxed);
+    stats.dropped = numDropped.load(std::memory_order_relaxed);
+    stats.drained = numDrained;
+    return stats;
+}
+
+void APIENTRY DebugOutput::Callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+{
+    Message entry;
+    entry.source = source;
+    entry.type = type;
+    entry.severity = severity;
+    entry.id = id;
+    const std::size_t textLength = std::min<std::size_t>(length >= 0 ? static_cast<std::size_t>(length) : std::strlen(message), kMaxMessageLength - 1);
+    std::memcpy(entry.text, message, textLength);
+    entry.text[textLength] = '\0';
+
+    while (producerLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    const bool isPushed = ring.TryPush(entry);
+    producerLock.clear(std::memory_order_release);
+
+    numReceived.fetch_add(1, std::memory_order_relaxed);
+    if (!isPushed)
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+}
@@ -2,5 +2,4 @@
 
 using namespace lgl;
 
-GLint error::status = 0;
-char error::errLog[error::ERROR_BUFFER];
+bool error::debugOutputEnabled = false;
@@ -0,0 +1,96 @@
+#include "lgl/Ext.h"
+#include <cstring>
+
+using namespace lgl;
+
+ext::PFNLGLGETPROGRAMBINARYPROC ext::GetProgramBinary = nullptr;
+ext::PFNLGLPROGRAMBINARYPROC ext::ProgramBinary = nullptr;
+ext::PFNLGLPROGRAMPARAMETERIPROC ext::ProgramParameteri = nullptr;
+ext::PFNLGLMAXSHADERCOMPILERTHREADSPROC ext::MaxShaderCompilerThreads = nullptr;
+ext::PFNLGLDEBUGMESSAGECALLBACKPROC ext::DebugMessageCallback = nullptr;
+ext::PFNLGLDEBUGMESSAGECONTROLPROC ext::DebugMessageControl = nullptr;
+
+static bool hasProgramBinary = false;
+static bool hasParallelShaderCompile = false;
+static bool hasTextureCompressionS3TC = false;
+static bool hasDebugOutput = false;
+
+void ext::Load(GLADloadproc load)
+{
+    // GL_ARB_get_program_binary
+    if (IsVersionAtLeast(4, 1) || IsSupported("GL_ARB_get_program_binary"))
+    {
+        GetProgramBinary = reinterpret_cast<PFNLGLGETPROGRAMBINARYPROC>(load("glGetProgramBinary"));
+        ProgramBinary = reinterpret_cast<PFNLGLPROGRAMBINARYPROC>(load("glProgramBinary"));
+        ProgramParameteri = reinterpret_cast<PFNLGLPROGRAMPARAMETERIPROC>(load("glProgramParameteri"));
+
+        // driver might expose the extension but doesn't support any binary format
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        hasProgramBinary = GetProgramBinary != nullptr && ProgramBinary != nullptr && ProgramParameteri != nullptr && numFormats > 0;
+    }
+
+    // GL_KHR_parallel_shader_compile
+    if (IsSupported("GL_KHR_parallel_shader_compile"))
+        MaxShaderCompilerThreads = reinterpret_cast<PFNLGLMAXSHADERCOMPILERTHREADSPROC>(load("glMaxShaderCompilerThreadsKHR"));
+    else if (IsSupported("GL_ARB_parallel_shader_compile"))
+        MaxShaderCompilerThreads = reinterpret_cast<PFNLGLMAXSHADERCOMPILERTHREADSPROC>(load("glMaxShaderCompilerThreadsARB"));
+    if (MaxShaderCompilerThreads != nullptr)
+    {
+        // let driver decide how many threads to use, some drivers use none until told so
+        MaxShaderCompilerThreads(0xFFFFFFFF);
+        hasParallelShaderCompile = true;
+    }
+
+    // GL_EXT_texture_compression_s3tc, enums only
+    hasTextureCompressionS3TC = IsSupported("GL_EXT_texture_compression_s3tc");
+
+    // GL_KHR_debug, its functions have no suffix on desktop OpenGL
+    if (IsVersionAtLeast(4, 3) || IsSupported("GL_KHR_debug"))
+    {
+        DebugMessageCallback = reinterpret_cast<PFNLGLDEBUGMESSAGECALLBACKPROC>(load("glDebugMessageCallback"));
+        DebugMessageControl = reinterpret_cast<PFNLGLDEBUGMESSAGECONTROLPROC>(load("glDebugMessageControl"));
+        hasDebugOutput = DebugMessageCallback != nullptr && DebugMessageControl != nullptr;
+    }
+}
+
+bool ext::IsSupported(const char* extension)
+{
+    GLint numExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+    for (GLint i=0; i<numExtensions; ++i)
+    {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (name != nullptr && std::strcmp(name, extension) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool ext::IsVersionAtLeast(int major, int minor)
+{
+    GLint majorVersion = 0, minorVersion = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    return majorVersion > major || (majorVersion == major && minorVersion >= minor);
+}
+
+bool ext::HasProgramBinary()
+{
+    return hasProgramBinary;
+}
+
+bool ext::HasParallelShaderCompile()
+{
+    return hasParallelShaderCompile;
+}
+
+bool ext::HasTextureCompressionS3TC()
+{
+    return hasTextureCompressionS3TC;
+}
+
+bool ext::HasDebugOutput()
+{
+    return hasDebugOutput;
+}
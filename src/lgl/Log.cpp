@@ -0,0 +1,717 @@
+#include "lgl/Log.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace lgl;
+using namespace lgl::log;
+
+namespace
+{
+
+const std::size_t kRingBytes = 64 * 1024;           // per thread, power of two
+const std::size_t kMaxStringBytes = 8 * 1024;       // of all string arguments of a message, the rest is truncated
+const unsigned int kMaxRepeatsPerSecond = 10;
+const int kWriteIntervalMs = 5;
+// records are multiple of this, so whatever is left before end of ring fits a padding header
+const std::size_t kRecordAlignment = 32;
+
+struct RecordHeader
+{
+    std::uint32_t size;         // including header, multiple of kRecordAlignment
+    std::uint8_t severity;
+    std::uint8_t numArgs;
+    std::uint8_t isPadding;     // filler up to end of ring, record continues from its beginning
+    std::uint8_t reserved;
+    const char* fmt;
+    std::int64_t timeNs;
+};
+
+// followed by null-terminated contents of its STRING arguments in order
+struct StoredArg
+{
+    std::uint64_t type;
+    union
+    {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+        std::size_t length;
+    };
+};
+
+static_assert(sizeof(RecordHeader) <= kRecordAlignment, "padding header must fit into smallest record");
+
+std::atomic<bool> isMuted(false);
+
+inline std::size_t RoundUpToRecord(std::size_t size)
+{
+    return (size + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+inline std::int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+====================
+Thread buffer
+====================
+*/
+
+// byte ring of variable-sized records, written only by its thread and read only by writer thread
+struct ThreadBuffer
+{
+    std::atomic<std::size_t> head;      // written by writer
+    char padHead[64];
+    std::atomic<std::size_t> tail;      // written by owning thread
+    char padTail[64];
+    std::size_t pendingTail;            // owning thread only, tail after record being written
+    std::atomic<bool> isRetired;        // owning thread has exited
+    unsigned int index;
+    unsigned char data[kRingBytes];
+
+    explicit ThreadBuffer(unsigned int index):
+        head(0),
+        tail(0),
+        pendingTail(0),
+        isRetired(false),
+        index(index)
+    {
+    }
+
+    // nullptr if there isn't enough space
+    unsigned char* Reserve(std::size_t size)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t offset = t & (kRingBytes - 1);
+        const std::size_t contiguous = kRingBytes - offset;
+        const std::size_t needed = size <= contiguous ? size : contiguous + size;
+        if (kRingBytes - (t - head.load(std::memory_order_acquire)) < needed)
+            return nullptr;
+
+        if (size <= contiguous)
+        {
+            pendingTail = t + size;
+            return data + offset;
+        }
+
+        RecordHeader padding = RecordHeader();
+        padding.size = static_cast<std::uint32_t>(contiguous);
+        padding.isPadding = 1;
+        std::memcpy(data + offset, &padding, sizeof(padding));
+        pendingTail = t + contiguous + size;
+        return data;
+    }
+
+    void Commit()
+    {
+        tail.store(pendingTail, std::memory_order_release);
+    }
+};
+
+/*
+====================
+Writer
+====================
+*/
+
+class Logger
+{
+public:
+    Logger():
+        isStopping(false),
+        numPasses(0),
+        numWritten(0),
+        numDropped(0),
+        numSuppressed(0),
+        nextIndex(0),
+        numDroppedReported(0),
+        startNs(NowNs())
+    {
+    }
+
+    ~Logger()
+    {
+        if (writer.joinable())
+        {
+            isStopping.store(true, std::memory_order_release);
+            Wake();
+            writer.join();
+        }
+        for (ThreadBuffer* buffer : buffers)
+            delete buffer;
+    }
+
+    ThreadBuffer* Register()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ThreadBuffer* buffer = new ThreadBuffer(nextIndex++);
+        buffers.push_back(buffer);
+        if (!writer.joinable())
+            writer = std::thread(&Logger::Run, this);
+        return buffer;
+    }
+
+    void Wake()
+    {
+        wake.notify_one();
+    }
+
+    void Flush()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!writer.joinable())
+                return;
+        }
+
+        // a pass which started after this call has seen everything queued before it
+        const std::uint64_t target = numPasses.load(std::memory_order_acquire) + 2;
+        while (numPasses.load(std::memory_order_acquire) < target)
+        {
+            Wake();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void AddDropped()
+    {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // write message right away instead of queueing it, after everything queued so far
+    void WriteNow(Severity severity, const char* fmt, const Arg* args, unsigned int numArgs)
+    {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        DrainAll(false);
+
+        StoredArg stored[16];
+        const char* strings[16];
+        for (unsigned int i=0; i<numArgs; ++i)
+        {
+            stored[i].type = args[i].type;
+            std::memcpy(&stored[i].u, &args[i].u, sizeof(stored[i].u));
+            strings[i] = args[i].type == Arg::STRING ? args[i].str : nullptr;
+        }
+
+        AppendPrefix(severity, NowNs(), nullptr);
+        AppendFormatted(fmt, stored, strings, numArgs);
+        if (out.back() != '\n')
+            out += '\n';
+        numWritten.fetch_add(1, std::memory_order_relaxed);
+        WriteOut();
+    }
+
+    LogStats GetStats() const
+    {
+        LogStats stats;
+        stats.written = numWritten.load(std::memory_order_relaxed);
+        stats.dropped = numDropped.load(std::memory_order_relaxed);
+        stats.suppressed = numSuppressed.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    enum LengthModifier
+    {
+        LENGTH_NONE,
+        LENGTH_LONG,
+        LENGTH_LONG_LONG,
+        LENGTH_INTMAX,
+        LENGTH_SIZE,
+        LENGTH_PTRDIFF,
+        LENGTH_LONG_DOUBLE
+    };
+
+    struct RateState
+    {
+        std::int64_t windowStartNs;
+        unsigned int count;
+        std::uint64_t suppressed;
+    };
+
+    std::mutex mutex;                   // guards buffers, nextIndex and starting writer
+    std::vector<ThreadBuffer*> buffers;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> isStopping;
+    std::atomic<std::uint64_t> numPasses;
+    std::atomic<std::uint64_t> numWritten;
+    std::atomic<std::uint64_t> numDropped;
+    std::atomic<std::uint64_t> numSuppressed;
+    unsigned int nextIndex;
+
+    // held by whoever drains, writer thread or one writing synchronously, guards everything below
+    std::mutex drainMutex;
+    std::uint64_t numDroppedReported;
+    std::int64_t startNs;
+    std::string out;
+    std::unordered_map<const char*, RateState> rates;
+
+    void Run()
+    {
+        for (;;)
+        {
+            const bool isLastPass = isStopping.load(std::memory_order_acquire);
+            {
+                std::lock_guard<std::mutex> lock(drainMutex);
+                DrainAll(isLastPass);
+            }
+            numPasses.fetch_add(1, std::memory_order_release);
+            if (isLastPass)
+                break;
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(kWriteIntervalMs));
+        }
+    }
+
+    void DrainAll(bool isLastPass)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t i=0; i<buffers.size(); )
+            {
+                ThreadBuffer* buffer = buffers[i];
+                // check before draining, so nothing is committed after it's drained
+                const bool isRetired = buffer->isRetired.load(std::memory_order_acquire);
+                Drain(*buffer);
+                if (isRetired)
+                {
+                    delete buffer;
+                    buffers[i] = buffers.back();
+                    buffers.pop_back();
+                }
+                else
+                    ++i;
+            }
+        }
+
+        const std::uint64_t dropped = numDropped.load(std::memory_order_relaxed);
+        if (dropped != numDroppedReported)
+        {
+            AppendPrefix(SEVERITY_WARN, NowNs(), nullptr);
+            AppendValue("%llu log messages were dropped as ring of their thread is full\n", static_cast<unsigned long long>(dropped - numDroppedReported));
+            numDroppedReported = dropped;
+        }
+        ReportSuppressed(isLastPass ? INT64_MAX : NowNs());
+        WriteOut();
+    }
+
+    void WriteOut()
+    {
+        if (out.empty())
+            return;
+
+        // keep order with what's been printed to stdout so far
+        std::fflush(stdout);
+        std::fwrite(out.data(), 1, out.size(), stderr);
+        std::fflush(stderr);
+        out.clear();
+    }
+
+    void Drain(ThreadBuffer& buffer)
+    {
+        std::size_t h = buffer.head.load(std::memory_order_relaxed);
+        const std::size_t t = buffer.tail.load(std::memory_order_acquire);
+        while (h != t)
+        {
+            const unsigned char* record = buffer.data + (h & (kRingBytes - 1));
+            RecordHeader header;
+            std::memcpy(&header, record, sizeof(header));
+            if (!header.isPadding)
+                WriteRecord(buffer.index, header, record);
+            h += header.size;
+            buffer.head.store(h, std::memory_order_release);
+        }
+    }
+
+    void WriteRecord(unsigned int threadIndex, const RecordHeader& header, const unsigned char* record)
+    {
+        if (header.severity < SEVERITY_ERROR && IsRateLimited(header.fmt, header.timeNs))
+            return;
+
+        const StoredArg* args = reinterpret_cast<const StoredArg*>(record + sizeof(RecordHeader));
+        const char* strings[16];
+        const char* str = reinterpret_cast<const char*>(args + header.numArgs);
+        for (unsigned int i=0; i<header.numArgs; ++i)
+        {
+            strings[i] = nullptr;
+            if (args[i].type == Arg::STRING)
+            {
+                strings[i] = str;
+                str += args[i].length + 1;
+            }
+        }
+
+        AppendPrefix(header.severity, header.timeNs, &threadIndex);
+        AppendFormatted(header.fmt, args, strings, header.numArgs);
+        if (out.empty() || out.back() != '\n')
+            out += '\n';
+        numWritten.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool IsRateLimited(const char* fmt, std::int64_t timeNs)
+    {
+        RateState& state = rates[fmt];
+        if (state.count == 0 || timeNs - state.windowStartNs >= 1000000000)
+        {
+            ReportSuppressed(fmt, state);
+            state.windowStartNs = timeNs;
+            state.count = 0;
+        }
+        if (++state.count <= kMaxRepeatsPerSecond)
+            return false;
+
+        ++state.suppressed;
+        numSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // report formats whose window has ended with suppressed repeats
+    void ReportSuppressed(std::int64_t nowNs)
+    {
+        for (auto& it : rates)
+        {
+            if (it.second.suppressed > 0 && nowNs - it.second.windowStartNs >= 1000000000)
+                ReportSuppressed(it.first, it.second);
+        }
+    }
+
+    void ReportSuppressed(const char* fmt, RateState& state)
+    {
+        if (state.suppressed == 0)
+            return;
+
+        AppendPrefix(SEVERITY_WARN, state.windowStartNs, nullptr);
+        AppendValue("%llu repeats of \"", static_cast<unsigned long long>(state.suppressed));
+        const char* end = std::strchr(fmt, '\n');
+        out.append(fmt, end != nullptr ? static_cast<std::size_t>(end - fmt) : std::strlen(fmt));
+        out += "\" were suppressed\n";
+        state.suppressed = 0;
+    }
+
+    void AppendPrefix(unsigned int severity, std::int64_t timeNs, const unsigned int* threadIndex)
+    {
+        static const char kSeverityTags[] = { 'D', 'I', 'W', 'E' };
+        const double seconds = static_cast<double>(timeNs - startNs) * 1e-9;
+        AppendValue("[%10.6f] [", seconds);
+        out += kSeverityTags[std::min(severity, 3u)];
+        if (threadIndex != nullptr)
+            AppendValue("] [t%u] ", *threadIndex);
+        else
+            out += "] ";
+    }
+
+    template <typename T>
+    void AppendValue(const char* spec, T value)
+    {
+        char small[128];
+        const int n = std::snprintf(small, sizeof(small), spec, value);
+        if (n < 0)
+            return;
+        if (static_cast<std::size_t>(n) < sizeof(small))
+        {
+            out.append(small, static_cast<std::size_t>(n));
+            return;
+        }
+
+        const std::size_t oldSize = out.size();
+        out.resize(oldSize + n + 1);
+        std::snprintf(&out[oldSize], n + 1, spec, value);
+        out.resize(oldSize + n);
+    }
+
+    static long long AsSigned(const StoredArg& arg)
+    {
+        switch (arg.type)
+        {
+            case Arg::INT: return arg.i;
+            case Arg::UINT: return static_cast<long long>(arg.u);
+            case Arg::DOUBLE: return static_cast<long long>(arg.d);
+            case Arg::POINTER: return static_cast<long long>(reinterpret_cast<std::intptr_t>(arg.p));
+            default: return 0;
+        }
+    }
+
+    static double AsDouble(const StoredArg& arg)
+    {
+        switch (arg.type)
+        {
+            case Arg::INT: return static_cast<double>(arg.i);
+            case Arg::UINT: return static_cast<double>(arg.u);
+            case Arg::DOUBLE: return arg.d;
+            default: return 0.0;
+        }
+    }
+
+    void AppendSigned(const char* spec, LengthModifier length, long long value)
+    {
+        switch (length)
+        {
+            case LENGTH_LONG: AppendValue(spec, static_cast<long>(value)); break;
+            case LENGTH_LONG_LONG: AppendValue(spec, value); break;
+            case LENGTH_INTMAX: AppendValue(spec, static_cast<std::intmax_t>(value)); break;
+            case LENGTH_SIZE:
+            case LENGTH_PTRDIFF: AppendValue(spec, static_cast<std::ptrdiff_t>(value)); break;
+            default: AppendValue(spec, static_cast<int>(value)); break;
+        }
+    }
+
+    void AppendUnsigned(const char* spec, LengthModifier length, unsigned long long value)
+    {
+        switch (length)
+        {
+            case LENGTH_LONG: AppendValue(spec, static_cast<unsigned long>(value)); break;
+            case LENGTH_LONG_LONG: AppendValue(spec, value); break;
+            case LENGTH_INTMAX: AppendValue(spec, static_cast<std::uintmax_t>(value)); break;
+            case LENGTH_SIZE:
+            case LENGTH_PTRDIFF: AppendValue(spec, static_cast<std::size_t>(value)); break;
+            default: AppendValue(spec, static_cast<unsigned int>(value)); break;
+        }
+    }
+
+    // printf-style formatting one conversion at a time, each with argument cast to what it expects
+    void AppendFormatted(const char* fmt, const StoredArg* args, const char* const* strings, unsigned int numArgs)
+    {
+        unsigned int next = 0;
+        const char* p = fmt;
+        while (*p != '\0')
+        {
+            if (*p != '%')
+            {
+                const char* percent = std::strchr(p, '%');
+                const std::size_t n = percent != nullptr ? static_cast<std::size_t>(percent - p) : std::strlen(p);
+                out.append(p, n);
+                p += n;
+                continue;
+            }
+            if (p[1] == '%')
+            {
+                out += '%';
+                p += 2;
+                continue;
+            }
+
+            // flags, width, precision, length modifier, then conversion
+            const char* s = p + 1;
+            while (*s != '\0' && std::strchr("-+ #0", *s) != nullptr)
+                ++s;
+            while (std::isdigit(static_cast<unsigned char>(*s)))
+                ++s;
+            if (*s == '.')
+            {
+                ++s;
+                while (std::isdigit(static_cast<unsigned char>(*s)))
+                    ++s;
+            }
+            LengthModifier length = LENGTH_NONE;
+            if (*s == 'h')
+                s += s[1] == 'h' ? 2 : 1;
+            else if (*s == 'l')
+            {
+                length = s[1] == 'l' ? LENGTH_LONG_LONG : LENGTH_LONG;
+                s += s[1] == 'l' ? 2 : 1;
+            }
+            else if (*s == 'j') { length = LENGTH_INTMAX; ++s; }
+            else if (*s == 'z') { length = LENGTH_SIZE; ++s; }
+            else if (*s == 't') { length = LENGTH_PTRDIFF; ++s; }
+            else if (*s == 'L') { length = LENGTH_LONG_DOUBLE; ++s; }
+
+            if (*s == '\0')
+            {
+                out.append(p);
+                break;
+            }
+
+            char spec[32];
+            const std::size_t specLength = static_cast<std::size_t>(s + 1 - p);
+            if (specLength >= sizeof(spec) || next >= numArgs)
+            {
+                out.append(p, specLength);
+                p = s + 1;
+                continue;
+            }
+            std::memcpy(spec, p, specLength);
+            spec[specLength] = '\0';
+
+            const StoredArg& arg = args[next];
+            const char* str = strings[next];
+            ++next;
+            switch (*s)
+            {
+                case 'd':
+                case 'i':
+                    AppendSigned(spec, length, AsSigned(arg));
+                    break;
+                case 'u':
+                case 'o':
+                case 'x':
+                case 'X':
+                    AppendUnsigned(spec, length, static_cast<unsigned long long>(AsSigned(arg)));
+                    break;
+                case 'c':
+                    AppendValue(spec, static_cast<int>(AsSigned(arg)));
+                    break;
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                    if (length == LENGTH_LONG_DOUBLE)
+                        AppendValue(spec, static_cast<long double>(AsDouble(arg)));
+                    else
+                        AppendValue(spec, AsDouble(arg));
+                    break;
+                case 's':
+                    AppendValue(spec, str != nullptr ? str : "(?)");
+                    break;
+                case 'p':
+                    AppendValue(spec, arg.type == Arg::POINTER ? arg.p : nullptr);
+                    break;
+                default:
+                    // unknown conversion or %n, print it as it is
+                    out.append(spec);
+                    break;
+            }
+            p = s + 1;
+        }
+    }
+};
+
+Logger& GetLogger()
+{
+    static Logger logger;
+    return logger;
+}
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+// buffer of this thread is retired, later messages are written synchronously
+thread_local bool isThreadRetired = false;
+
+// retires buffer of its thread when thread exits, writer frees it after draining
+struct ThreadRetirer
+{
+    ~ThreadRetirer()
+    {
+        if (threadBuffer != nullptr)
+            threadBuffer->isRetired.store(true, std::memory_order_release);
+        threadBuffer = nullptr;
+        isThreadRetired = true;
+    }
+};
+
+// nullptr once thread-local objects of this thread are destroyed
+ThreadBuffer* GetThreadBuffer()
+{
+    if (isThreadRetired)
+        return nullptr;
+
+    if (threadBuffer == nullptr)
+    {
+        static thread_local ThreadRetirer retirer;
+        (void)retirer;
+        threadBuffer = GetLogger().Register();
+    }
+    return threadBuffer;
+}
+
+}
+
+void log::Submit(Severity severity, const char* fmt, const Arg* args, unsigned int numArgs)
+{
+    if (isMuted.load(std::memory_order_relaxed))
+        return;
+
+    std::size_t stringLengths[16];
+    std::size_t stringBytes = 0;
+    for (unsigned int i=0; i<numArgs; ++i)
+    {
+        if (args[i].type == Arg::STRING)
+        {
+            stringLengths[i] = std::min(args[i].length, kMaxStringBytes - stringBytes);
+            stringBytes += stringLengths[i];
+        }
+    }
+    const std::size_t size = RoundUpToRecord(sizeof(RecordHeader) + numArgs * sizeof(StoredArg) + stringBytes + numArgs);
+
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer == nullptr)
+    {
+        // thread-local objects of this thread are gone, so a new buffer would never be retired.
+        // Happens e.g. when a static destructor logs
+        GetLogger().WriteNow(severity, fmt, args, numArgs);
+        return;
+    }
+
+    unsigned char* record = buffer->Reserve(size);
+    while (record == nullptr)
+    {
+        // errors usually precede exit, they wait for writer instead of being dropped
+        if (severity < SEVERITY_ERROR)
+        {
+            GetLogger().AddDropped();
+            return;
+        }
+        GetLogger().Wake();
+        std::this_thread::yield();
+        record = buffer->Reserve(size);
+    }
+
+    RecordHeader header;
+    header.size = static_cast<std::uint32_t>(size);
+    header.severity = static_cast<std::uint8_t>(severity);
+    header.numArgs = static_cast<std::uint8_t>(numArgs);
+    header.isPadding = 0;
+    header.reserved = 0;
+    header.fmt = fmt;
+    header.timeNs = NowNs();
+    std::memcpy(record, &header, sizeof(header));
+
+    StoredArg* stored = reinterpret_cast<StoredArg*>(record + sizeof(RecordHeader));
+    char* str = reinterpret_cast<char*>(stored + numArgs);
+    for (unsigned int i=0; i<numArgs; ++i)
+    {
+        stored[i].type = args[i].type;
+        if (args[i].type == Arg::STRING)
+        {
+            stored[i].length = stringLengths[i];
+            std::memcpy(str, args[i].str, stringLengths[i]);
+            str[stringLengths[i]] = '\0';
+            str += stringLengths[i] + 1;
+        }
+        else
+            std::memcpy(&stored[i].u, &args[i].u, sizeof(stored[i].u));
+    }
+
+    buffer->Commit();
+}
+
+void log::Flush()
+{
+    GetLogger().Flush();
+}
+
+void log::SetMuted(bool muted)
+{
+    isMuted.store(muted, std::memory_order_relaxed);
+}
+
+log::LogStats log::GetStats()
+{
+    return GetLogger().GetStats();
+}
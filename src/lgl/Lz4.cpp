@@ -0,0 +1,191 @@
+#include "lgl/Lz4.h"
+#include "lgl/Types.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace lgl;
+
+namespace
+{
+
+const std::size_t kMinMatch = 4;
+const std::size_t kLastLiterals = 5;        // the last 5 bytes are always literals
+const std::size_t kMatchSafeDistance = 12;  // the last match starts at least 12 bytes before the end
+const std::size_t kMaxOffset = 65535;
+const int kHashBits = 12;
+
+inline std::uint32_t Read32(const unsigned char* p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint32_t Hash(std::uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+/**
+ * Write length beyond what fits in 4 bits of token as run of 255 bytes plus remainder.
+ */
+inline unsigned char* WriteLength(unsigned char* op, std::size_t length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+}
+
+/**
+ * Write sequence of literals followed by match, or only literals if matchLength is 0.
+ */
+unsigned char* WriteSequence(unsigned char* op, const unsigned char* literals, std::size_t numLiterals, std::size_t offset, std::size_t matchLength)
+{
+    unsigned char* token = op++;
+    *token = static_cast<unsigned char>((numLiterals >= 15 ? 15 : numLiterals) << 4);
+    if (numLiterals >= 15)
+        op = WriteLength(op, numLiterals - 15);
+    if (numLiterals > 0)
+        std::memcpy(op, literals, numLiterals);
+    op += numLiterals;
+
+    if (matchLength == 0)
+        return op;
+
+    *op++ = static_cast<unsigned char>(offset & 0xFF);
+    *op++ = static_cast<unsigned char>(offset >> 8);
+    const std::size_t extra = matchLength - kMinMatch;
+    *token |= static_cast<unsigned char>(extra >= 15 ? 15 : extra);
+    if (extra >= 15)
+        op = WriteLength(op, extra - 15);
+    return op;
+}
+
+}
+
+std::size_t lz4::CompressBlock(const void* src, std::size_t srcSize, void* dst)
+{
+    const unsigned char* const base = static_cast<const unsigned char*>(src);
+    const unsigned char* const end = base + srcSize;
+    unsigned char* op = static_cast<unsigned char*>(dst);
+
+    const unsigned char* anchor = base;
+    if (srcSize > kMatchSafeDistance)
+    {
+        // positions + 1 so 0 means empty
+        std::vector<std::uint32_t> table(1u << kHashBits, 0);
+        const unsigned char* const matchLimit = end - kLastLiterals;
+        const unsigned char* const searchLimit = end - kMatchSafeDistance;
+
+        const unsigned char* ip = base;
+        while (ip < searchLimit)
+        {
+            const std::uint32_t sequence = Read32(ip);
+            const std::uint32_t h = Hash(sequence);
+            const std::uint32_t candidate = table[h];
+            table[h] = static_cast<std::uint32_t>(ip - base) + 1;
+
+            if (candidate == 0 || static_cast<std::size_t>(ip - base) + 1 - candidate > kMaxOffset ||
+                Read32(base + candidate - 1) != sequence)
+            {
+                ++ip;
+                continue;
+            }
+
+            const unsigned char* match = base + candidate - 1;
+            // extend backward into pending literals
+            while (ip > anchor && match > base && ip[-1] == match[-1])
+            {
+                --ip;
+                --match;
+            }
+            const unsigned char* matchEnd = ip + kMinMatch;
+            const unsigned char* ref = match + kMinMatch;
+            while (matchEnd < matchLimit && *matchEnd == *ref)
+            {
+                ++matchEnd;
+                ++ref;
+            }
+
+            op = WriteSequence(op, anchor, static_cast<std::size_t>(ip - anchor), static_cast<std::size_t>(ip - match),
+                               static_cast<std::size_t>(matchEnd - ip));
+            ip = matchEnd;
+            anchor = ip;
+        }
+    }
+
+    op = WriteSequence(op, anchor, static_cast<std::size_t>(end - anchor), 0, 0);
+    return static_cast<std::size_t>(op - static_cast<unsigned char*>(dst));
+}
+
+int lz4::DecompressBlock(const void* src, std::size_t srcSize, void* dst, std::size_t dstSize)
+{
+    const unsigned char* ip = static_cast<const unsigned char*>(src);
+    const unsigned char* const ipEnd = ip + srcSize;
+    unsigned char* const outBase = static_cast<unsigned char*>(dst);
+    unsigned char* op = outBase;
+    unsigned char* const opEnd = outBase + dstSize;
+
+    while (ip < ipEnd)
+    {
+        const unsigned int token = *ip++;
+
+        std::size_t numLiterals = token >> 4;
+        if (numLiterals == 15)
+        {
+            unsigned int b;
+            do
+            {
+                if (ip >= ipEnd)
+                    return LGL_FAIL;
+                b = *ip++;
+                numLiterals += b;
+            } while (b == 255);
+        }
+        if (numLiterals > static_cast<std::size_t>(ipEnd - ip) || numLiterals > static_cast<std::size_t>(opEnd - op))
+            return LGL_FAIL;
+        if (numLiterals > 0)
+            std::memcpy(op, ip, numLiterals);
+        ip += numLiterals;
+        op += numLiterals;
+
+        // the last sequence has no match
+        if (ip == ipEnd)
+            break;
+
+        if (ipEnd - ip < 2)
+            return LGL_FAIL;
+        const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - outBase))
+            return LGL_FAIL;
+
+        std::size_t matchLength = (token & 15) + kMinMatch;
+        if ((token & 15) == 15)
+        {
+            unsigned int b;
+            do
+            {
+                if (ip >= ipEnd)
+                    return LGL_FAIL;
+                b = *ip++;
+                matchLength += b;
+            } while (b == 255);
+        }
+        if (matchLength > static_cast<std::size_t>(opEnd - op))
+            return LGL_FAIL;
+
+        // byte by byte as match may overlap its own output
+        const unsigned char* match = op - offset;
+        for (std::size_t i=0; i<matchLength; ++i)
+            op[i] = match[i];
+        op += matchLength;
+    }
+
+    return op == opEnd ? LGL_SUCCESS : LGL_FAIL;
+}
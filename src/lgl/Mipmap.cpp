@@ -0,0 +1,219 @@
+#include "lgl/Mipmap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) && !defined(LGL_NO_SIMD)
+#define LGL_MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace lgl;
+
+namespace
+{
+
+/**
+ * Conversion tables between 8-bit sRGB and 16-bit linear.
+ * Linear to sRGB is indexed by the top 12 bits, each step is less than one 8-bit sRGB step.
+ */
+struct SRGBTables
+{
+    std::uint16_t toLinear[256];
+    unsigned char toSRGB[4096];
+
+    SRGBTables()
+    {
+        for (int i=0; i<256; ++i)
+        {
+            const double c = i / 255.0;
+            const double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+            toLinear[i] = static_cast<std::uint16_t>(linear * 65535.0 + 0.5);
+        }
+        for (int i=0; i<4096; ++i)
+        {
+            // center of the range this entry covers
+            const double linear = (i * 16 + 8) / 65535.0;
+            const double c = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            toSRGB[i] = static_cast<unsigned char>(std::min(255.0, c * 255.0 + 0.5));
+        }
+    }
+};
+
+// built once on first use, thread-safe since C++11
+const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+/**
+ * Whether channel is a color channel, rather than alpha.
+ */
+inline bool IsColorChannel(int channel, int nrChannels)
+{
+    return !((nrChannels == 4 && channel == 3) || (nrChannels == 2 && channel == 1));
+}
+
+/**
+ * Sum each byte of two rows into 16-bit lanes.
+ */
+void SumRows(const unsigned char* row0, const unsigned char* row1, int numBytes, std::uint16_t* sums)
+{
+    int i = 0;
+#ifdef LGL_MIPMAP_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= numBytes; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+        const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i + 8), hi);
+    }
+#endif
+    for (; i<numBytes; ++i)
+        sums[i] = static_cast<std::uint16_t>(row0[i] + row1[i]);
+}
+
+#ifdef LGL_MIPMAP_SSE2
+/**
+ * Downsample row pair of 4-channel linear pixels, 8 source pixels into 4 per iteration.
+ *
+ * \return Number of destination pixels written
+ */
+int DownsampleRowRGBA(const unsigned char* row0, const unsigned char* row1, int dstWidth, unsigned char* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    int x = 0;
+    for (; x + 4 <= dstWidth; x += 4)
+    {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8 + 16));
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8 + 16));
+
+        // vertical sums, 2 pixels per register
+        const __m128i v0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        const __m128i v1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        const __m128i v2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        const __m128i v3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // horizontal sums of adjacent pixels land in the low half
+        const __m128i h0 = _mm_add_epi16(v0, _mm_shuffle_epi32(v0, 0x4E));
+        const __m128i h1 = _mm_add_epi16(v1, _mm_shuffle_epi32(v1, 0x4E));
+        const __m128i h2 = _mm_add_epi16(v2, _mm_shuffle_epi32(v2, 0x4E));
+        const __m128i h3 = _mm_add_epi16(v3, _mm_shuffle_epi32(v3, 0x4E));
+
+        // rounded average
+        const __m128i p01 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h0, h1), two), 2);
+        const __m128i p23 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h2, h3), two), 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(p01, p23));
+    }
+    return x;
+}
+#endif
+
+}
+
+int mipmap::GetNumLevels(int width, int height)
+{
+    int numLevels = 1;
+    while (width > 1 || height > 1)
+    {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++numLevels;
+    }
+    return numLevels;
+}
+
+std::size_t mipmap::GetChainSize(int width, int height, int nrChannels)
+{
+    std::size_t size = static_cast<std::size_t>(width) * height * nrChannels;
+    while (width > 1 || height > 1)
+    {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        size += static_cast<std::size_t>(width) * height * nrChannels;
+    }
+    return size;
+}
+
+void mipmap::Downsample(const unsigned char* src, int width, int height, int nrChannels, bool isSRGB, unsigned char* dst)
+{
+    const int dstWidth = std::max(1, width / 2);
+    const int dstHeight = std::max(1, height / 2);
+    const std::size_t srcPitch = static_cast<std::size_t>(width) * nrChannels;
+    const std::size_t dstPitch = static_cast<std::size_t>(dstWidth) * nrChannels;
+    // dimension of 1 is repeated to form 2x2
+    const int stepX = width > 1 ? nrChannels : 0;
+
+    std::vector<std::uint16_t> sums;
+    if (!isSRGB)
+        sums.resize(srcPitch);
+    const SRGBTables* tables = isSRGB ? &GetSRGBTables() : nullptr;
+
+    for (int y=0; y<dstHeight; ++y)
+    {
+        const unsigned char* row0 = src + srcPitch * (height > 1 ? y * 2 : 0);
+        const unsigned char* row1 = height > 1 ? row0 + srcPitch : row0;
+        unsigned char* out = dst + dstPitch * y;
+
+        if (isSRGB)
+        {
+            for (int x=0; x<dstWidth; ++x)
+            {
+                for (int c=0; c<nrChannels; ++c)
+                {
+                    const std::size_t i = static_cast<std::size_t>(x) * 2 * nrChannels + c;
+                    if (IsColorChannel(c, nrChannels))
+                    {
+                        const std::uint32_t sum = tables->toLinear[row0[i]] + tables->toLinear[row0[i + stepX]] +
+                                                  tables->toLinear[row1[i]] + tables->toLinear[row1[i + stepX]];
+                        out[x * nrChannels + c] = tables->toSRGB[((sum + 2) >> 2) >> 4];
+                    }
+                    else
+                    {
+                        out[x * nrChannels + c] = static_cast<unsigned char>((row0[i] + row0[i + stepX] + row1[i] + row1[i + stepX] + 2) >> 2);
+                    }
+                }
+            }
+            continue;
+        }
+
+        int x = 0;
+#ifdef LGL_MIPMAP_SSE2
+        if (nrChannels == 4 && width > 1)
+            x = DownsampleRowRGBA(row0, row1, dstWidth, out);
+#endif
+        if (x == dstWidth)
+            continue;
+
+        SumRows(row0, row1, static_cast<int>(srcPitch), sums.data());
+        for (; x<dstWidth; ++x)
+        {
+            for (int c=0; c<nrChannels; ++c)
+            {
+                const std::size_t i = static_cast<std::size_t>(x) * 2 * nrChannels + c;
+                out[x * nrChannels + c] = static_cast<unsigned char>((sums[i] + sums[i + stepX] + 2) >> 2);
+            }
+        }
+    }
+}
+
+void mipmap::GenerateChain(unsigned char* chain, int width, int height, int nrChannels, bool isSRGB)
+{
+    unsigned char* level = chain;
+    while (width > 1 || height > 1)
+    {
+        unsigned char* next = level + static_cast<std::size_t>(width) * height * nrChannels;
+        Downsample(level, width, height, nrChannels, isSRGB, next);
+        level = next;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+}
@@ -0,0 +1,124 @@
+#include "lgl/PixelBufferRing.h"
+#include "lgl/Error.h"
+#include "lgl/Types.h"
+
+using namespace lgl;
+
+PixelBufferRing::PixelBufferRing():
+    next(0),
+    numStalls(0)
+{
+}
+
+int PixelBufferRing::Create(unsigned int numBuffers, std::size_t initialSize)
+{
+    slots.resize(numBuffers);
+    for (Slot& slot : slots)
+    {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, initialSize, nullptr, GL_STREAM_DRAW);
+        slot.capacity = initialSize;
+        slot.fence = nullptr;
+        slot.isAcquired = false;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    next = 0;
+    numStalls = 0;
+
+    if (lgl::error::AnyGLError() != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error creating %u pixel buffers of %zu bytes", numBuffers, initialSize);
+#endif
+        Destroy();
+        return LGL_FAIL;
+    }
+    return LGL_SUCCESS;
+}
+
+void PixelBufferRing::Destroy()
+{
+    for (Slot& slot : slots)
+    {
+        if (slot.fence != nullptr)
+            glDeleteSync(slot.fence);
+        // deleting mapped buffer unmaps it
+        glDeleteBuffers(1, &slot.buffer);
+    }
+    slots.clear();
+}
+
+int PixelBufferRing::Acquire(std::size_t size)
+{
+    const unsigned int numSlots = static_cast<unsigned int>(slots.size());
+    bool isAnyInFlight = false;
+    for (unsigned int i=0; i<numSlots; ++i)
+    {
+        const unsigned int index = (next + i) % numSlots;
+        Slot& slot = slots[index];
+        if (slot.isAcquired)
+            continue;
+
+        if (slot.fence != nullptr)
+        {
+            // only check, never wait
+            const GLenum result = glClientWaitSync(slot.fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+            {
+                isAnyInFlight = true;
+                continue;
+            }
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+
+        if (slot.capacity < size)
+        {
+            // GPU is done with it, so it's safe to re-specify its storage
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            slot.capacity = size;
+        }
+
+        slot.isAcquired = true;
+        next = (index + 1) % numSlots;
+        return static_cast<int>(index);
+    }
+
+    if (isAnyInFlight)
+        ++numStalls;
+    return LGL_FAIL;
+}
+
+void* PixelBufferRing::Map(int slot)
+{
+    Slot& s = slots[slot];
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.buffer);
+    // GPU is known to be done with this buffer via fence, so driver doesn't need to synchronize
+    void* ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, s.capacity, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return ptr;
+}
+
+int PixelBufferRing::UnmapAndBind(int slot)
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slots[slot].buffer);
+    if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        slots[slot].isAcquired = false;
+        return LGL_FAIL;
+    }
+    return LGL_SUCCESS;
+}
+
+void PixelBufferRing::Release(int slot)
+{
+    Slot& s = slots[slot];
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s.isAcquired = false;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
@@ -0,0 +1,205 @@
+#include "lgl/ProgramCache.h"
+#include "lgl/Ext.h"
+#include "lgl/Error.h"
+#include "lgl/Hash.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace lgl;
+
+#define CACHE_FILE_MAGIC "LGLP"
+#define CACHE_FILE_VERSION 1
+
+// header of each cached program binary file, followed by binary itself
+struct CacheFileHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t key;
+    std::uint32_t binaryFormat;
+    std::uint32_t length;
+};
+
+std::string ProgramCache::directory;
+std::uint64_t ProgramCache::driverHash = 0;
+ProgramCacheStats ProgramCache::stats = { 0, 0, 0, 0.0, 0.0 };
+
+void ProgramCache::SetDirectory(const char* dir)
+{
+    if (dir == nullptr || !ext::HasProgramBinary())
+    {
+        directory.clear();
+        return;
+    }
+
+    directory = dir;
+#ifdef _WIN32
+    _mkdir(dir);
+#else
+    mkdir(dir, 0755);
+#endif
+
+    // binary is only valid for the exact driver that produced it
+    const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    driverHash = hash::Fnv1a64(nullptr, 0);
+    for (GLenum name : names)
+    {
+        const char* str = reinterpret_cast<const char*>(glGetString(name));
+        if (str != nullptr)
+            driverHash = hash::Fnv1a64(str, std::strlen(str) + 1, driverHash);
+    }
+}
+
+bool ProgramCache::IsEnabled()
+{
+    return !directory.empty();
+}
+
+std::uint64_t ProgramCache::ComputeKey(const char* vertexShaderStr, const char* fragmentShaderStr)
+{
+    // include null-terminator to separate sources
+    std::uint64_t key = hash::Fnv1a64(vertexShaderStr, std::strlen(vertexShaderStr) + 1, driverHash);
+    return hash::Fnv1a64(fragmentShaderStr, std::strlen(fragmentShaderStr) + 1, key);
+}
+
+std::string ProgramCache::GetFilePath(std::uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016llx.bin", static_cast<unsigned long long>(key));
+    return directory + name;
+}
+
+GLuint ProgramCache::Load(const char* vertexShaderStr, const char* fragmentShaderStr)
+{
+    if (!IsEnabled())
+        return 0;
+
+    const std::uint64_t key = ComputeKey(vertexShaderStr, fragmentShaderStr);
+    const std::string path = GetFilePath(key);
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return 0;
+
+    // length in header is trusted only as far as the file actually holds that many bytes,
+    // so a corrupted file can't make it allocate gigabytes
+    long fileSize = -1;
+    if (std::fseek(file, 0, SEEK_END) == 0)
+        fileSize = std::ftell(file);
+    std::rewind(file);
+
+    CacheFileHeader header;
+    std::vector<char> binary;
+    bool valid = fileSize >= static_cast<long>(sizeof(header)) &&
+                 std::fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, CACHE_FILE_MAGIC, 4) == 0 &&
+                 header.version == CACHE_FILE_VERSION &&
+                 header.key == key &&
+                 header.length <= static_cast<unsigned long>(fileSize) - sizeof(header);
+    if (valid)
+    {
+        binary.resize(header.length);
+        valid = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    std::fclose(file);
+
+    if (!valid)
+    {
+        std::remove(path.c_str());
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    ext::ProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint status = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status)
+    {
+        // i.e. driver is updated without changing its version string, just compile from source
+        // and overwrite it
+        glDeleteProgram(program);
+        std::remove(path.c_str());
+        ++stats.rejected;
+        return 0;
+    }
+
+    return program;
+}
+
+void ProgramCache::PrepareForLink(GLuint program)
+{
+    if (IsEnabled())
+        ext::ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::Save(GLuint program, const char* vertexShaderStr, const char* fragmentShaderStr)
+{
+    if (!IsEnabled())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    CacheFileHeader header;
+    std::memcpy(header.magic, CACHE_FILE_MAGIC, 4);
+    header.version = CACHE_FILE_VERSION;
+    header.key = ComputeKey(vertexShaderStr, fragmentShaderStr);
+
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum binaryFormat = 0;
+    ext::GetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+    header.binaryFormat = binaryFormat;
+    header.length = static_cast<std::uint32_t>(written);
+
+    // write into temporary file then rename, so other process won't see partially written file
+    const std::string path = GetFilePath(header.key);
+    const std::string tmpPath = path + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot write program binary cache %s", tmpPath.c_str());
+#endif
+        return;
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(binary.data(), 1, header.length, file) == header.length;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmpPath.c_str());
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot write program binary cache %s", path.c_str());
+#endif
+    }
+}
+
+const ProgramCacheStats& ProgramCache::GetStats()
+{
+    return stats;
+}
+
+void ProgramCache::RecordBuildTime(bool fromCache, double seconds)
+{
+    if (fromCache)
+    {
+        ++stats.hits;
+        stats.hitSeconds += seconds;
+    }
+    else
+    {
+        ++stats.misses;
+        stats.missSeconds += seconds;
+    }
+}
@@ -0,0 +1,41 @@
+#include "lgl/Sampler.h"
+#include "lgl/TextureUnits.h"
+
+using namespace lgl;
+
+std::vector<Sampler::Entry> Sampler::entries;
+
+GLuint Sampler::Get(const TextureSampling& sampling)
+{
+    for (const Entry& entry : entries)
+    {
+        if (entry.sampling == sampling)
+            return entry.sampler;
+    }
+
+    Entry entry;
+    entry.sampling = sampling;
+    glGenSamplers(1, &entry.sampler);
+    glSamplerParameteri(entry.sampler, GL_TEXTURE_WRAP_S, sampling.wrapS);
+    glSamplerParameteri(entry.sampler, GL_TEXTURE_WRAP_T, sampling.wrapT);
+    glSamplerParameteri(entry.sampler, GL_TEXTURE_MIN_FILTER, sampling.minFilter);
+    glSamplerParameteri(entry.sampler, GL_TEXTURE_MAG_FILTER, sampling.magFilter);
+    entries.push_back(entry);
+    return entry.sampler;
+}
+
+void Sampler::Clear()
+{
+    for (const Entry& entry : entries)
+    {
+        // OpenGL unbinds deleted sampler from all units
+        TextureUnits::ForgetSampler(entry.sampler);
+        glDeleteSamplers(1, &entry.sampler);
+    }
+    entries.clear();
+}
+
+unsigned int Sampler::GetNumSamplers()
+{
+    return static_cast<unsigned int>(entries.size());
+}
@@ -2,146 +2,699 @@
 #include "lgl/Wrapped_GL.h"
 #include "lgl/Util.h"
 #include "lgl/PBits.h"
+#include "lgl/ProgramCache.h"
+#include "lgl/Ext.h"
+#include "lgl/Vfs.h"
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
 
 using namespace lgl;
 
-Shader::Shader()
+GLuint Shader::boundProgram = 0;
+
+// size in bytes of a single element of uniform type which can be set via Shader::SetUniform(),
+// 0 for type that is not shadowed
+static unsigned int UniformShadowSize(GLenum type)
 {
+    switch (type)
+    {
+        case GL_FLOAT:
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_ARRAY:
+            return 4;
+        case GL_FLOAT_VEC2:
+            return 8;
+        case GL_FLOAT_VEC3:
+            return 12;
+        case GL_FLOAT_VEC4:
+            return 16;
+        case GL_FLOAT_MAT4:
+            return 64;
+    }
+    return 0;
 }
 
-int Shader::BuildFromSrc(const char* vertexShaderStr, const char* fragmentShaderStr)
+namespace
 {
-    GLint glError = 0;
 
-    // VERTEX SHADER
-    // read in vertex shader from source
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+// owns shader object, and deletes it when going out of scope unless it's released
+class ShaderObjectGuard
+{
+public:
+    explicit ShaderObjectGuard(GLuint shader): shader(shader) { }
+    ~ShaderObjectGuard()
+    {
+        if (shader != 0)
+            glDeleteShader(shader);
+    }
 
-    // compile vertex shader
-    glShaderSource(vertexShader, 1, &vertexShaderStr, NULL);
-    glCompileShader(vertexShader);
-    glError = error::AnyGLShaderError(vertexShader);
-    if (glError != 0)
+    GLuint Get() const { return shader; }
+    GLuint Release()
     {
+        GLuint released = shader;
+        shader = 0;
+        return released;
+    }
+
+private:
+    GLuint shader;
+
+    ShaderObjectGuard(const ShaderObjectGuard&);
+    ShaderObjectGuard& operator=(const ShaderObjectGuard&);
+};
+
+// owns program object, and deletes it when going out of scope unless it's released
+class ProgramObjectGuard
+{
+public:
+    explicit ProgramObjectGuard(GLuint program): program(program) { }
+    ~ProgramObjectGuard()
+    {
+        if (program != 0)
+            glDeleteProgram(program);
+    }
+
+    GLuint Get() const { return program; }
+    GLuint Release()
+    {
+        GLuint released = program;
+        program = 0;
+        return released;
+    }
+
+private:
+    GLuint program;
+
+    ProgramObjectGuard(const ProgramObjectGuard&);
+    ProgramObjectGuard& operator=(const ProgramObjectGuard&);
+};
+
+}
+
 #ifndef LGL_NODEBUG
-        lgl::error::ErrorWarn("%s has error", vertexShader);
-#endif
-        return -1;
+// find where line number is in a line of info log, drivers format it differently
+//   Mesa:   "0:12(5): error: ..."
+//   NVIDIA: "0(12) : error C0000: ..."
+//   AMD:    "ERROR: 0:12: ..."
+static bool FindLogLineNumber(const std::string& line, std::size_t& begin, std::size_t& end)
+{
+    std::size_t p = 0;
+    if (line.compare(0, 7, "ERROR: ") == 0)
+        p = 7;
+    else if (line.compare(0, 9, "WARNING: ") == 0)
+        p = 9;
+
+    // source string number
+    std::size_t q = p;
+    while (q < line.size() && std::isdigit(static_cast<unsigned char>(line[q])))
+        ++q;
+    if (q == p || q >= line.size() || (line[q] != ':' && line[q] != '('))
+        return false;
+
+    begin = q + 1;
+    end = begin;
+    while (end < line.size() && std::isdigit(static_cast<unsigned char>(line[end])))
+        ++end;
+    return end > begin;
+}
+
+// get line (1-based) of source, empty if out of range
+static std::string GetSourceLine(const std::string& source, unsigned int lineNumber)
+{
+    std::size_t begin = 0;
+    for (unsigned int i=1; i<lineNumber; ++i)
+    {
+        begin = source.find('\n', begin);
+        if (begin == std::string::npos)
+            return std::string();
+        ++begin;
     }
+    std::size_t end = source.find('\n', begin);
+    return source.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+// print info log of shader with line numbers mapped back to its original source before defines
+// are injected, along with offending line of source
+static void PrintShaderInfoLog(GLuint shader, const char* label, unsigned int numInjectedLines)
+{
+    GLint length = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    std::string log(length > 0 ? length : 1, '\0');
+    glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, &log[0]);
+    log.resize(std::strlen(log.c_str()));
 
-    // FRAGMENT SHADER
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &length);
+    std::string source(length > 0 ? length : 1, '\0');
+    glGetShaderSource(shader, static_cast<GLsizei>(source.size()), nullptr, &source[0]);
+    source.resize(std::strlen(source.c_str()));
 
-    // compile fragment shader
-    glShaderSource(fragmentShader, 1, &fragmentShaderStr, NULL);
-    glCompileShader(fragmentShader);
+    // defines are injected right after #version line, see Shader::InjectDefines()
+    unsigned int versionLine = 0;
+    const std::size_t versionAt = source.find("#version");
+    if (versionAt != std::string::npos)
+        versionLine = static_cast<unsigned int>(std::count(source.begin(), source.begin() + versionAt, '\n')) + 1;
 
-    glError = error::AnyGLShaderError(fragmentShader);
-    if (glError != 0)
+    std::size_t lineBegin = 0;
+    while (lineBegin < log.size())
     {
+        std::size_t lineEnd = log.find('\n', lineBegin);
+        if (lineEnd == std::string::npos)
+            lineEnd = log.size();
+        std::string line = log.substr(lineBegin, lineEnd - lineBegin);
+        lineBegin = lineEnd + 1;
+        if (line.empty())
+            continue;
+
+        std::size_t numBegin, numEnd;
+        if (!FindLogLineNumber(line, numBegin, numEnd))
+        {
+            lgl::error::ErrorPrint("%s: %s", label, line.c_str());
+            continue;
+        }
+
+        const unsigned int reported = static_cast<unsigned int>(std::strtoul(line.c_str() + numBegin, nullptr, 10));
+        if (reported > versionLine && reported <= versionLine + numInjectedLines)
+        {
+            lgl::error::ErrorPrint("%s: (injected define) %s", label, line.c_str());
+        }
+        else
+        {
+            const unsigned int mapped = reported > versionLine ? reported - numInjectedLines : reported;
+            line.replace(numBegin, numEnd - numBegin, std::to_string(mapped));
+            lgl::error::ErrorPrint("%s: %s", label, line.c_str());
+        }
+        lgl::error::ErrorPrint("    | %s", GetSourceLine(source, reported).c_str());
+    }
+}
+#endif
+
+// query compile status of shader, and print its error if failed
+static bool IsShaderCompiled(GLuint shader, const char* label, unsigned int numInjectedLines)
+{
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status == GL_TRUE)
+        return true;
+
 #ifndef LGL_NODEBUG
-        lgl::error::ErrorWarn("%s has error", fragmentShader);
+    lgl::error::ErrorPrint("Error compiling %s", label);
+    PrintShaderInfoLog(shader, label, numInjectedLines);
 #endif
+    return false;
+}
+
+// query link status of program, and print its error if failed
+static bool IsProgramLinked(GLuint program, const char* vertexLabel, const char* fragmentLabel)
+{
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_TRUE)
+        return true;
+
+#ifndef LGL_NODEBUG
+    GLint length = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    std::string log(length > 0 ? length : 1, '\0');
+    glGetProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, &log[0]);
+    lgl::error::ErrorPrint("Error linking %s and %s: %s", vertexLabel, fragmentLabel, log.c_str());
+#endif
+    return false;
+}
+
+// upload a single element of uniform type as shadowed, see UniformShadowSize()
+static void UploadUniform(GLint location, GLenum type, const void* value)
+{
+    switch (type)
+    {
+        case GL_FLOAT:
+            glUniform1fv(location, 1, static_cast<const GLfloat*>(value));
+            break;
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_ARRAY:
+            glUniform1iv(location, 1, static_cast<const GLint*>(value));
+            break;
+        case GL_FLOAT_VEC2:
+            glUniform2fv(location, 1, static_cast<const GLfloat*>(value));
+            break;
+        case GL_FLOAT_VEC3:
+            glUniform3fv(location, 1, static_cast<const GLfloat*>(value));
+            break;
+        case GL_FLOAT_VEC4:
+            glUniform4fv(location, 1, static_cast<const GLfloat*>(value));
+            break;
+        case GL_FLOAT_MAT4:
+            glUniformMatrix4fv(location, 1, GL_FALSE, static_cast<const GLfloat*>(value));
+            break;
+    }
+}
+
+Shader::Shader():
+    program(0)
+{
+    pending.vertexShader = 0;
+    pending.fragmentShader = 0;
+    pending.numInjectedLines = 0;
+    uploadStats.issued = 0;
+    uploadStats.skipped = 0;
+}
+
+int Shader::BuildFromSrc(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines)
+{
+    if (BuildFromSrcAsync(vertexShaderStr, fragmentShaderStr, defines) != 0)
         return -1;
+    return FinishBuild();
+}
+
+int Shader::BuildFromSrcAsync(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines)
+{
+    return StartBuild(vertexShaderStr, fragmentShaderStr, defines, "vertex shader", "fragment shader");
+}
+
+int Shader::StartBuild(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines, const char* vertexLabel, const char* fragmentLabel)
+{
+    assert(!IsBuildPending() && "FinishBuild() must be called before starting another build");
+
+    std::string vsCode, fsCode;
+    if (!defines.empty())
+    {
+        vsCode = InjectDefines(vertexShaderStr, defines);
+        fsCode = InjectDefines(fragmentShaderStr, defines);
+        vertexShaderStr = vsCode.c_str();
+        fragmentShaderStr = fsCode.c_str();
     }
 
-    // link all shaders together
-    program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    glError = error::AnyGLShaderProgramError(program);
-    if (glError != 0)
+    // building again replaces program of previous build
+    if (program != 0)
+        Destroy();
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // try to skip compilation entirely by loading program binary cached from previous run
+    GLuint cachedProgram = ProgramCache::Load(vertexShaderStr, fragmentShaderStr);
+    if (cachedProgram != 0)
+    {
+        program = cachedProgram;
+        ReflectUniforms();
+        ProgramCache::RecordBuildTime(true, std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+        return 0;
+    }
+
+    // objects are deleted when going out of scope unless they're handed over to pending build
+    ShaderObjectGuard vertexShader(glCreateShader(GL_VERTEX_SHADER));
+    ShaderObjectGuard fragmentShader(glCreateShader(GL_FRAGMENT_SHADER));
+    ProgramObjectGuard newProgram(glCreateProgram());
+    if (vertexShader.Get() == 0 || fragmentShader.Get() == 0 || newProgram.Get() == 0)
     {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot create shader objects for %s and %s", vertexLabel, fragmentLabel);
+#endif
         return -1;
     }
 
-    // delete un-needed shader objects
-    // note: in fact, it will mark them for deletion after our usage of shader program is done
-    // they will be deleted after that
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // issue compilation of both shaders and linking back to back without querying any status
+    // in between, querying is what makes driver wait for the result
+    glShaderSource(vertexShader.Get(), 1, &vertexShaderStr, NULL);
+    glCompileShader(vertexShader.Get());
+
+    glShaderSource(fragmentShader.Get(), 1, &fragmentShaderStr, NULL);
+    glCompileShader(fragmentShader.Get());
+
+    glAttachShader(newProgram.Get(), vertexShader.Get());
+    glAttachShader(newProgram.Get(), fragmentShader.Get());
+    ProgramCache::PrepareForLink(newProgram.Get());
+    glLinkProgram(newProgram.Get());
+
+    program = newProgram.Release();
+    pending.vertexShader = vertexShader.Release();
+    pending.fragmentShader = fragmentShader.Release();
+    pending.vertexLabel = vertexLabel;
+    pending.fragmentLabel = fragmentLabel;
+    pending.numInjectedLines = static_cast<unsigned int>(defines.size());
+    pending.startTime = startTime;
+    if (ProgramCache::IsEnabled())
+    {
+        pending.vertexShaderStr = vertexShaderStr;
+        pending.fragmentShaderStr = fragmentShaderStr;
+    }
 
     return 0;
 }
 
-int Shader::Build(const char* vertexPath, const char* fragmentPath)
+bool Shader::IsReady() const
+{
+    if (!IsBuildPending() || !ext::HasParallelShaderCompile())
+        return true;
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+int Shader::FinishBuild()
 {
-    util::FileReader fileReader;
-    bool error = false;
-    GLint glError = 0;
+    if (!IsBuildPending())
+        return 0;
+
+    // take over ownership of all objects of pending build, they're deleted on any error below.
+    // Shader objects are always deleted, linked program keeps what it needs from them.
+    ShaderObjectGuard vertexShader(pending.vertexShader);
+    ShaderObjectGuard fragmentShader(pending.fragmentShader);
+    ProgramObjectGuard newProgram(program);
+    pending.vertexShader = 0;
+    pending.fragmentShader = 0;
+    program = 0;
 
-    // VERTEX SHADER
-    // read in vertex shader from source
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    std::string vsCode = fileReader.ReadAll(vertexPath, error);
-    if (error)
+    // these block until driver is done with compilation and linking.
+    // Check both shaders to report all errors at once, link status is only meaningful if both are compiled.
+    const bool isVertexCompiled = IsShaderCompiled(vertexShader.Get(), pending.vertexLabel.c_str(), pending.numInjectedLines);
+    const bool isFragmentCompiled = IsShaderCompiled(fragmentShader.Get(), pending.fragmentLabel.c_str(), pending.numInjectedLines);
+    const bool isLinked = isVertexCompiled && isFragmentCompiled &&
+                          IsProgramLinked(newProgram.Get(), pending.vertexLabel.c_str(), pending.fragmentLabel.c_str());
+
+    if (isLinked)
     {
-        return -1;
+        program = newProgram.Release();
+        ReflectUniforms();
+        if (!pending.vertexShaderStr.empty())
+            ProgramCache::Save(program, pending.vertexShaderStr.c_str(), pending.fragmentShaderStr.c_str());
+        ProgramCache::RecordBuildTime(false, std::chrono::duration<double>(std::chrono::steady_clock::now() - pending.startTime).count());
     }
 
-    // compile vertex shader
-    const char* t = vsCode.c_str();
-    glShaderSource(vertexShader, 1, &t, NULL);
-    glCompileShader(vertexShader);
-    glError = error::AnyGLShaderError(vertexShader);
-    if (glError != 0)
+    pending.vertexShaderStr.clear();
+    pending.fragmentShaderStr.clear();
+    return isLinked ? 0 : -1;
+}
+
+int Shader::ReadSources(const char* vertexPath, const char* fragmentPath, std::string& vsCode, std::string& fsCode)
+{
+    if (vfs::ReadText(vertexPath, vsCode) != LGL_SUCCESS)
     {
 #ifndef LGL_NODEBUG
-        lgl::error::ErrorWarn("%s has error", vertexPath);
+        lgl::error::ErrorWarn("Cannot read %s", vertexPath);
 #endif
         return -1;
     }
 
-    // FRAGMENT SHADER
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    std::string fsCode = fileReader.ReadAll(fragmentPath, error);
-    if (error)
+    if (vfs::ReadText(fragmentPath, fsCode) != LGL_SUCCESS)
     {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot read %s", fragmentPath);
+#endif
         return -1;
     }
 
-    // compile fragment shader
-    t = fsCode.c_str();
-    glShaderSource(fragmentShader, 1, &t, NULL);
-    glCompileShader(fragmentShader);
+    return 0;
+}
 
-    glError = error::AnyGLShaderError(fragmentShader);
-    if (glError != 0)
+int Shader::Build(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines)
+{
+    if (BuildAsync(vertexPath, fragmentPath, defines) != 0 || FinishBuild() != 0)
     {
 #ifndef LGL_NODEBUG
-        lgl::error::ErrorWarn("%s has error", fragmentShader);
+        lgl::error::ErrorWarn("Error building shader from %s and %s", vertexPath, fragmentPath);
 #endif
         return -1;
     }
 
-    // link all shaders together
-    program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    glError = error::AnyGLShaderProgramError(program);
-    if (glError != 0)
-    {
+    return 0;
+}
+
+int Shader::BuildAsync(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines)
+{
+    std::string vsCode, fsCode;
+    if (ReadSources(vertexPath, fragmentPath, vsCode, fsCode) != 0)
         return -1;
+
+    // sources are consumed by glShaderSource() right away, so they don't need to outlive this call
+    return StartBuild(vsCode.c_str(), fsCode.c_str(), defines, vertexPath, fragmentPath);
+}
+
+std::string Shader::InjectDefines(const char* src, const ShaderDefines& defines)
+{
+    ShaderDefines sorted(defines);
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string lines;
+    for (const std::string& define : sorted)
+    {
+        lines += "#define ";
+        lines += define;
+        lines += '\n';
     }
+    // "NAME=VALUE" is written as "NAME VALUE"
+    std::replace(lines.begin(), lines.end(), '=', ' ');
 
-    // delete un-needed shader objects
-    // note: in fact, it will mark them for deletion after our usage of shader program is done
-    // they will be deleted after that
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // "#version" must be the first thing in GLSL source, so defines go right after its line
+    std::string code(src);
+    std::size_t insertAt = 0;
+    const std::size_t versionAt = code.find("#version");
+    if (versionAt != std::string::npos)
+    {
+        const std::size_t lineEnd = code.find('\n', versionAt);
+        if (lineEnd == std::string::npos)
+        {
+            code += '\n';
+            insertAt = code.size();
+        }
+        else
+        {
+            insertAt = lineEnd + 1;
+        }
+    }
 
-    return 0;
+    code.insert(insertAt, lines);
+    return code;
+}
+
+void Shader::ReplaceProgram(Shader& built)
+{
+    assert(!built.IsBuildPending() && "FinishBuild() of built shader must be called before replacing program");
+
+    // carry over values set through this shader, so user doesn't need to set them all again
+    glUseProgram(built.program);
+    for (const UniformInfo& info : uniforms)
+    {
+        if (info.type == GL_NONE || info.location >= static_cast<GLint>(shadowSlots.size()) || !shadowSlots[info.location].valid)
+            continue;
+
+        const int index = built.FindUniform(info.hash, info.name.c_str());
+        if (index == LGL_FAIL || built.uniforms[index].type != info.type)
+            continue;
+
+        const ShadowSlot& slot = shadowSlots[info.location];
+        const GLint newLocation = built.uniforms[index].location;
+        UploadUniform(newLocation, info.type, shadowValues.data() + slot.offset);
+
+        // keep shadow of new program in sync with what is just uploaded
+        ShadowSlot& newSlot = built.shadowSlots[newLocation];
+        std::memcpy(built.shadowValues.data() + newSlot.offset, shadowValues.data() + slot.offset, slot.size);
+        newSlot.valid = true;
+    }
+
+    const bool wasInUse = boundProgram == program;
+    glUseProgram(wasInUse ? built.program : boundProgram);
+
+    Destroy();
+    *this = std::move(built);
+    built = Shader();
+
+    if (wasInUse)
+        boundProgram = program;
 }
 
 void Shader::Use() const
 {
-    glUseProgram(program);    
+    if (boundProgram == program)
+        return;
+
+    glUseProgram(program);
+    boundProgram = program;
+}
+
+void Shader::InvalidateBoundProgram()
+{
+    boundProgram = 0;
 }
 
 void Shader::Destroy()
 {
+    if (IsBuildPending())
+    {
+        ShaderObjectGuard vertexShader(pending.vertexShader);
+        ShaderObjectGuard fragmentShader(pending.fragmentShader);
+        pending.vertexShader = 0;
+        pending.fragmentShader = 0;
+        pending.vertexShaderStr.clear();
+        pending.fragmentShaderStr.clear();
+    }
+    if (boundProgram == program)
+        boundProgram = 0;
     glDeleteProgram(program);
-    vnamesHashmap.clear();
+    program = 0;
+    uniformHashes.clear();
+    uniforms.clear();
+    locationIndices.clear();
+    missedHashes.clear();
+    shadowSlots.clear();
+    shadowValues.clear();
+}
+
+int Shader::BindUniformBlock(const char* blockName, GLuint bindingPoint)
+{
+    GLuint index = glGetUniformBlockIndex(program, blockName);
+    if (index == GL_INVALID_INDEX)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot find uniform block %s of shader %u", blockName, program);
+#endif
+        return LGL_FAIL;
+    }
+
+    glUniformBlockBinding(program, index, bindingPoint);
+    return LGL_SUCCESS;
+}
+
+void Shader::InvalidateUniformShadow()
+{
+    for (auto& slot : shadowSlots)
+        slot.valid = false;
+}
+
+void Shader::SetupUniformShadow()
+{
+    shadowSlots.clear();
+    shadowValues.clear();
+
+    ShadowSlot empty;
+    empty.offset = 0;
+    empty.size = 0;
+    empty.valid = false;
+    shadowSlots.assign(locationIndices.size(), empty);
+
+    unsigned int offset = 0;
+    for (const auto& u : uniforms)
+    {
+        const unsigned int size = UniformShadowSize(u.type);
+        if (size == 0)
+            continue;
+
+        ShadowSlot& slot = shadowSlots[u.location];
+        slot.offset = offset;
+        slot.size = size;
+        offset += size;
+    }
+    shadowValues.assign(offset, 0);
+}
+
+void Shader::ReflectUniforms()
+{
+    uniformHashes.clear();
+    uniforms.clear();
+    locationIndices.clear();
+    missedHashes.clear();
+
+    GLint numUniforms = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    uniformHashes.reserve(numUniforms);
+    uniforms.reserve(numUniforms);
+    std::vector<char> name(maxNameLength + 1);
+
+    for (GLint i=0; i<numUniforms; ++i)
+    {
+        GLsizei length = 0;
+        UniformInfo info;
+        glGetActiveUniform(program, static_cast<GLuint>(i), maxNameLength, &length, &info.size, &info.type, name.data());
+
+        // array is reported with "[0]" suffix, but users refer to it by its base name
+        if (length > 3 && std::strcmp(name.data() + length - 3, "[0]") == 0)
+        {
+            length -= 3;
+            name[length] = '\0';
+        }
+
+        info.location = glGetUniformLocation(program, name.data());
+        // member of uniform block has no location, it's set through buffer object instead
+        if (info.location == -1)
+            continue;
+
+        info.name.assign(name.data(), length);
+        info.hash = lgl::hash::Fnv1a(info.name.c_str());
+        uniforms.push_back(info);
+    }
+
+    // sort all at once rather than inserting one by one, stable to keep the same order as AddUniform()
+    std::stable_sort(uniforms.begin(), uniforms.end(), [](const UniformInfo& a, const UniformInfo& b) { return a.hash < b.hash; });
+    for (const auto& u : uniforms)
+        uniformHashes.push_back(u.hash);
+    RebuildLocationIndices();
+
+    SetupUniformShadow();
+}
+
+void Shader::AddUniform(const UniformInfo& info)
+{
+    auto it = std::upper_bound(uniformHashes.begin(), uniformHashes.end(), info.hash);
+    const int index = static_cast<int>(it - uniformHashes.begin());
+    uniformHashes.insert(it, info.hash);
+    uniforms.insert(uniforms.begin() + index, info);
+
+    // indices after insertion point are shifted
+    RebuildLocationIndices();
+}
+
+void Shader::RebuildLocationIndices()
+{
+    // only reflected uniform owns its location, not an alias
+    GLint maxLocation = -1;
+    for (const auto& u : uniforms)
+        maxLocation = std::max(maxLocation, u.location);
+    locationIndices.assign(maxLocation + 1, LGL_FAIL);
+    for (int i=0; i<static_cast<int>(uniforms.size()); ++i)
+    {
+        if (uniforms[i].type != GL_NONE)
+            locationIndices[uniforms[i].location] = i;
+    }
+}
+
+GLint Shader::LookupUniformLocation(std::uint32_t hash, const char* vname)
+{
+    if (std::find(missedHashes.begin(), missedHashes.end(), hash) != missedHashes.end())
+        return LGL_FAIL;
+
+    GLint location = glGetUniformLocation(program, vname);
+    if (location == -1)
+    {
+        // NOT FOUND
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot find uniform variable location for %s of shader %u", vname, program);
+#endif
+        missedHashes.push_back(hash);
+        return LGL_FAIL;
+    }
+
+    // i.e. individual element of array, it's not enumerated as active uniform.
+    // Save it as alias which doesn't own its location, so next lookup won't need to query OpenGL.
+    UniformInfo info;
+    info.hash = hash;
+    info.location = location;
+    info.type = GL_NONE;
+    info.size = 0;
+    info.name = vname;
+    AddUniform(info);
+
+    return location;
 }
@@ -0,0 +1,172 @@
+#include "lgl/ShaderRegistry.h"
+#include "lgl/Hash.h"
+#include <cstring>
+
+using namespace lgl;
+
+std::unordered_map<std::uint64_t, ShaderRegistry::Bucket> ShaderRegistry::entries;
+ShaderRegistry::Bucket ShaderRegistry::failedEntries;
+
+Shader* ShaderRegistry::Acquire(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines)
+{
+    return Acquire(vertexShaderStr, fragmentShaderStr, defines, false);
+}
+
+Shader* ShaderRegistry::AcquireAsync(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines)
+{
+    return Acquire(vertexShaderStr, fragmentShaderStr, defines, true);
+}
+
+Shader* ShaderRegistry::Acquire(const char* vertexShaderStr, const char* fragmentShaderStr, const ShaderDefines& defines, bool async)
+{
+    // each variant is keyed by its final sources, InjectDefines() sorts defines so their order doesn't matter
+    std::string vsCode, fsCode;
+    if (!defines.empty())
+    {
+        vsCode = Shader::InjectDefines(vertexShaderStr, defines);
+        fsCode = Shader::InjectDefines(fragmentShaderStr, defines);
+        vertexShaderStr = vsCode.c_str();
+        fragmentShaderStr = fsCode.c_str();
+    }
+
+    // include null-terminator to separate sources
+    std::uint64_t key = hash::Fnv1a64(vertexShaderStr, std::strlen(vertexShaderStr) + 1);
+    key = hash::Fnv1a64(fragmentShaderStr, std::strlen(fragmentShaderStr) + 1, key);
+
+    // different sources might collide on the same hash, compare sources within its bucket
+    Bucket& bucket = entries[key];
+    for (std::size_t i=0; i<bucket.size(); ++i)
+    {
+        Entry& entry = *bucket[i];
+        if (entry.vertexShaderStr != vertexShaderStr || entry.fragmentShaderStr != fragmentShaderStr)
+            continue;
+
+        // its build acquired via AcquireAsync() earlier failed already, build it anew
+        if (!entry.shader.IsBuildPending() && !entry.shader.IsBuilt())
+        {
+            RetireFailed(bucket, i);
+            break;
+        }
+        // it might be still building if acquired via AcquireAsync() earlier
+        if (!async && entry.shader.FinishBuild() != 0)
+        {
+            RetireFailed(bucket, i);
+            if (bucket.empty())
+                entries.erase(key);
+            return nullptr;
+        }
+        ++entry.refCount;
+        return &entry.shader;
+    }
+
+    std::unique_ptr<Entry> entry(new Entry());
+    const int result = async ? entry->shader.BuildFromSrcAsync(vertexShaderStr, fragmentShaderStr) :
+                               entry->shader.BuildFromSrc(vertexShaderStr, fragmentShaderStr);
+    if (result != 0)
+    {
+        if (bucket.empty())
+            entries.erase(key);
+        return nullptr;
+    }
+    entry->vertexShaderStr = vertexShaderStr;
+    entry->fragmentShaderStr = fragmentShaderStr;
+    entry->refCount = 1;
+
+    bucket.push_back(std::move(entry));
+    return &bucket.back()->shader;
+}
+
+void ShaderRegistry::RetireFailed(Bucket& bucket, std::size_t index)
+{
+    // whoever acquired it still holds a pointer to it, keep it until they release it
+    failedEntries.push_back(std::move(bucket[index]));
+    bucket.erase(bucket.begin() + index);
+}
+
+void ShaderRegistry::Release(Shader* shader)
+{
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        Bucket& bucket = it->second;
+        for (std::size_t i=0; i<bucket.size(); ++i)
+        {
+            Entry& entry = *bucket[i];
+            if (&entry.shader != shader)
+                continue;
+
+            if (--entry.refCount == 0)
+            {
+                entry.shader.Destroy();
+                bucket.erase(bucket.begin() + i);
+                if (bucket.empty())
+                    entries.erase(it);
+            }
+            return;
+        }
+    }
+
+    for (std::size_t i=0; i<failedEntries.size(); ++i)
+    {
+        Entry& entry = *failedEntries[i];
+        if (&entry.shader != shader)
+            continue;
+
+        if (--entry.refCount == 0)
+        {
+            entry.shader.Destroy();
+            failedEntries.erase(failedEntries.begin() + i);
+        }
+        return;
+    }
+
+#ifndef LGL_NODEBUG
+    lgl::error::ErrorWarn("Released shader is not acquired from ShaderRegistry");
+#endif
+}
+
+bool ShaderRegistry::IsAllReady()
+{
+    for (auto& kv : entries)
+    {
+        for (const std::unique_ptr<Entry>& entry : kv.second)
+        {
+            if (!entry->shader.IsReady())
+                return false;
+        }
+    }
+    return true;
+}
+
+int ShaderRegistry::FinishAll()
+{
+    int result = LGL_SUCCESS;
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        Bucket& bucket = it->second;
+        for (std::size_t i=0; i<bucket.size();)
+        {
+            if (bucket[i]->shader.FinishBuild() != 0)
+            {
+                RetireFailed(bucket, i);
+                result = LGL_FAIL;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        if (bucket.empty())
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+    return result;
+}
+
+std::size_t ShaderRegistry::GetNumPrograms()
+{
+    std::size_t numPrograms = 0;
+    for (auto& kv : entries)
+        numPrograms += kv.second.size();
+    return numPrograms;
+}
@@ -0,0 +1,269 @@
+#include "lgl/ShaderWatcher.h"
+#include "lgl/Error.h"
+#include "lgl/Types.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace lgl;
+
+// how long background thread waits for file changes before checking whether it should stop
+#define WATCH_POLL_TIMEOUT_MS 100
+
+ShaderWatcher::ShaderWatcher():
+    inotifyFd(-1),
+    running(false)
+{
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    Stop();
+}
+
+int ShaderWatcher::Start()
+{
+#ifdef __linux__
+    if (running)
+        return LGL_SUCCESS;
+
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot initialize inotify for watching shader files");
+#endif
+        return LGL_FAIL;
+    }
+
+    // watch directories of shaders which are added before starting
+    for (const Entry& entry : entries)
+    {
+        std::string dir;
+        MakeWatchPath(entry.vertexPath.c_str(), dir);
+        WatchDir(dir);
+        MakeWatchPath(entry.fragmentPath.c_str(), dir);
+        WatchDir(dir);
+    }
+
+    running = true;
+    thread = std::thread(&ShaderWatcher::ThreadMain, this);
+    return LGL_SUCCESS;
+#else
+#ifndef LGL_NODEBUG
+    lgl::error::ErrorWarn("Watching shader files is not supported on this platform");
+#endif
+    return LGL_FAIL;
+#endif
+}
+
+void ShaderWatcher::Stop()
+{
+#ifdef __linux__
+    if (running)
+    {
+        running = false;
+        thread.join();
+    }
+    if (inotifyFd >= 0)
+    {
+        // closing it also removes all of its watches
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+    watchedDirs.clear();
+#endif
+
+    for (Entry& entry : entries)
+    {
+        if (entry.isBuilding)
+        {
+            entry.building.Destroy();
+            entry.isBuilding = false;
+        }
+    }
+}
+
+int ShaderWatcher::Watch(Shader& shader, const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines, const ReloadCallback& onReload)
+{
+    Unwatch(shader);
+
+    Entry entry;
+    entry.shader = &shader;
+    entry.vertexPath = vertexPath;
+    entry.fragmentPath = fragmentPath;
+    entry.defines = defines;
+    entry.onReload = onReload;
+    entry.isBuilding = false;
+    entry.isDirty = false;
+
+    std::string vertexDir, fragmentDir;
+    entry.vertexWatchPath = MakeWatchPath(vertexPath, vertexDir);
+    entry.fragmentWatchPath = MakeWatchPath(fragmentPath, fragmentDir);
+    entries.push_back(std::move(entry));
+
+    // otherwise directories will be watched when started
+    if (inotifyFd < 0)
+        return LGL_SUCCESS;
+
+    if (WatchDir(vertexDir) != LGL_SUCCESS || WatchDir(fragmentDir) != LGL_SUCCESS)
+        return LGL_FAIL;
+    return LGL_SUCCESS;
+}
+
+void ShaderWatcher::Unwatch(const Shader& shader)
+{
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (it->shader != &shader)
+            continue;
+
+        if (it->isBuilding)
+            it->building.Destroy();
+        entries.erase(it);
+        return;
+    }
+}
+
+int ShaderWatcher::Poll()
+{
+    std::vector<std::string> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changed.swap(changedPaths);
+    }
+
+    for (Entry& entry : entries)
+    {
+        if (std::find(changed.begin(), changed.end(), entry.vertexWatchPath) != changed.end() ||
+            std::find(changed.begin(), changed.end(), entry.fragmentWatchPath) != changed.end())
+            entry.isDirty = true;
+    }
+
+    int numReplaced = 0;
+    for (Entry& entry : entries)
+    {
+        if (entry.isBuilding && entry.building.IsReady())
+        {
+            entry.isBuilding = false;
+            if (entry.building.FinishBuild() == 0)
+            {
+                entry.shader->ReplaceProgram(entry.building);
+                ++numReplaced;
+                if (entry.onReload)
+                    entry.onReload(*entry.shader);
+            }
+            else
+            {
+#ifndef LGL_NODEBUG
+                lgl::error::ErrorPrint("Error reloading shader from %s and %s, keep using the old one", entry.vertexPath.c_str(), entry.fragmentPath.c_str());
+#endif
+            }
+        }
+
+        // only one build per shader at a time, the latest change gets built after current one is done
+        if (entry.isDirty && !entry.isBuilding)
+            StartRebuild(entry);
+    }
+
+    return numReplaced;
+}
+
+void ShaderWatcher::StartRebuild(Entry& entry)
+{
+    entry.isDirty = false;
+    if (entry.building.BuildAsync(entry.vertexPath.c_str(), entry.fragmentPath.c_str(), entry.defines) == 0)
+        entry.isBuilding = true;
+#ifndef LGL_NODEBUG
+    else
+        lgl::error::ErrorPrint("Error reloading shader from %s and %s, keep using the old one", entry.vertexPath.c_str(), entry.fragmentPath.c_str());
+#endif
+}
+
+void ShaderWatcher::ThreadMain()
+{
+#ifdef __linux__
+    // large enough for many events at once, aligned as required by inotify
+    alignas(struct inotify_event) char buffer[4096];
+
+    while (running)
+    {
+        struct pollfd pfd;
+        pfd.fd = inotifyFd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, WATCH_POLL_TIMEOUT_MS) <= 0)
+            continue;
+
+        ssize_t length;
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (char* ptr = buffer; ptr < buffer + length; )
+            {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+                ptr += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0)
+                    continue;
+
+                // watchedDirs is guarded by the same mutex, see WatchDir()
+                for (const WatchedDir& watched : watchedDirs)
+                {
+                    if (watched.wd == event->wd)
+                    {
+                        changedPaths.push_back(watched.dir + "/" + event->name);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+#endif
+}
+
+int ShaderWatcher::WatchDir(const std::string& dir)
+{
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const WatchedDir& watched : watchedDirs)
+    {
+        if (watched.dir == dir)
+            return LGL_SUCCESS;
+    }
+
+    // IN_CLOSE_WRITE for saving in-place, IN_MOVED_TO for saving via renaming temporary file
+    const int wd = inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot watch directory %s", dir.c_str());
+#endif
+        return LGL_FAIL;
+    }
+
+    WatchedDir watched;
+    watched.wd = wd;
+    watched.dir = dir;
+    watchedDirs.push_back(watched);
+    return LGL_SUCCESS;
+#else
+    return LGL_FAIL;
+#endif
+}
+
+std::string ShaderWatcher::MakeWatchPath(const char* path, std::string& dir)
+{
+    std::string p(path);
+    const std::size_t slash = p.find_last_of('/');
+    if (slash == std::string::npos)
+    {
+        dir = ".";
+        return "./" + p;
+    }
+
+    dir = p.substr(0, slash);
+    return p;
+}
@@ -0,0 +1,210 @@
+#include "lgl/TextureAtlas.h"
+#include "lgl/Util.h"
+#include "lgl/Mipmap.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/Vfs.h"
+#include "lgl/Error.h"
+#include "lgl/Types.h"
+#include "stb_image.h"
+#include <algorithm>
+
+// imgui compiles its own copy as static too, so both can be linked into the same program
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+// stbrp_setup_heuristic() is unused, and being static it warns
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "imgui/imstb_rectpack.h"
+#pragma GCC diagnostic pop
+
+using namespace lgl;
+
+TextureAtlas::TextureAtlas():
+    pageWidth(2048),
+    pageHeight(2048),
+    gutter(4),
+    maxMipLevel(2)
+{
+}
+
+void TextureAtlas::Create(int pageWidth, int pageHeight, int gutter, int maxMipLevel)
+{
+    this->pageWidth = pageWidth;
+    this->pageHeight = pageHeight;
+    this->gutter = gutter;
+    this->maxMipLevel = maxMipLevel;
+}
+
+int TextureAtlas::Add(const char* filepath)
+{
+    vfs::FileData file;
+    if (vfs::Open(filepath, file) != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error loading %s [cannot open file]", filepath);
+#endif
+        return LGL_FAIL;
+    }
+
+    // the same orientation as lgl::util::LoadTexture()
+    stbi_set_flip_vertically_on_load(true);
+
+    int width, height, nrChannels;
+    unsigned char* data = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &width, &height, &nrChannels, 4);
+    if (data == nullptr)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error loading %s [%s]", filepath, stbi_failure_reason());
+#endif
+        return LGL_FAIL;
+    }
+
+    const int id = Add(data, width, height, 4);
+    stbi_image_free(data);
+    return id;
+}
+
+int TextureAtlas::Add(const unsigned char* pixels, int width, int height, int nrChannels)
+{
+    Image image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<std::size_t>(width) * height * 4);
+
+    // expand the same way stb_image does for requested 4 channels
+    for (std::size_t i=0; i<static_cast<std::size_t>(width) * height; ++i)
+    {
+        const unsigned char* src = pixels + i * nrChannels;
+        unsigned char* dst = &image.pixels[i * 4];
+        switch (nrChannels)
+        {
+        case 1: dst[0] = dst[1] = dst[2] = src[0]; dst[3] = 255; break;
+        case 2: dst[0] = dst[1] = dst[2] = src[0]; dst[3] = src[1]; break;
+        case 3: dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255; break;
+        default: dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = src[3]; break;
+        }
+    }
+
+    images.push_back(std::move(image));
+    AtlasRect rect = { 0, 0.0f, 0.0f, 0.0f, 0.0f };
+    rects.push_back(rect);
+    return static_cast<int>(images.size()) - 1;
+}
+
+void TextureAtlas::Blit(const Image& image, int x, int y, int regionWidth, int regionHeight, std::vector<unsigned char>& page) const
+{
+    // fill whole cells, not only gutter, so mipmaps of the last cell row and column are made of edge pixels as well
+    for (int py=0; py<regionHeight; ++py)
+    {
+        const int sy = std::min(std::max(py - gutter, 0), image.height - 1);
+        unsigned char* dst = &page[(static_cast<std::size_t>(y + py) * pageWidth + x) * 4];
+        for (int px=0; px<regionWidth; ++px)
+        {
+            const int sx = std::min(std::max(px - gutter, 0), image.width - 1);
+            const unsigned char* src = &image.pixels[(static_cast<std::size_t>(sy) * image.width + sx) * 4];
+            std::copy(src, src + 4, dst + px * 4);
+        }
+    }
+}
+
+int TextureAtlas::Build()
+{
+    DeletePages();
+
+    // pack in units of cells, so each image starts and ends at boundary of the smallest mipmap level texel
+    const int cellSize = 1 << maxMipLevel;
+    const int numCellsX = pageWidth / cellSize;
+    const int numCellsY = pageHeight / cellSize;
+
+    std::vector<stbrp_rect> remaining(images.size());
+    for (std::size_t i=0; i<images.size(); ++i)
+    {
+        stbrp_rect& r = remaining[i];
+        r.id = static_cast<int>(i);
+        r.w = static_cast<stbrp_coord>((images[i].width + gutter * 2 + cellSize - 1) / cellSize);
+        r.h = static_cast<stbrp_coord>((images[i].height + gutter * 2 + cellSize - 1) / cellSize);
+        if (r.w > numCellsX || r.h > numCellsY)
+        {
+#ifndef LGL_NODEBUG
+            lgl::error::ErrorWarn("Image %d of %dx%d with its gutter doesn't fit in atlas page of %dx%d",
+                r.id, images[i].width, images[i].height, pageWidth, pageHeight);
+#endif
+            return LGL_FAIL;
+        }
+    }
+
+    std::vector<stbrp_node> nodes(numCellsX);
+    std::vector<unsigned char> chain;
+    while (!remaining.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, numCellsX, numCellsY, nodes.data(), numCellsX);
+        stbrp_pack_rects(&context, remaining.data(), static_cast<int>(remaining.size()));
+
+        // page is at the beginning of its mipmap chain
+        chain.assign(mipmap::GetChainSize(pageWidth, pageHeight, 4), 0);
+        std::vector<stbrp_rect> unpacked;
+        const int page = static_cast<int>(pages.size());
+        for (const stbrp_rect& r : remaining)
+        {
+            if (!r.was_packed)
+            {
+                unpacked.push_back(r);
+                continue;
+            }
+
+            const Image& image = images[r.id];
+            const int x = r.x * cellSize;
+            const int y = r.y * cellSize;
+            Blit(image, x, y, r.w * cellSize, r.h * cellSize, chain);
+
+            AtlasRect& rect = rects[r.id];
+            rect.page = page;
+            rect.u0 = static_cast<float>(x + gutter) / pageWidth;
+            rect.v0 = static_cast<float>(y + gutter) / pageHeight;
+            rect.u1 = static_cast<float>(x + gutter + image.width) / pageWidth;
+            rect.v1 = static_cast<float>(y + gutter + image.height) / pageHeight;
+        }
+        remaining.swap(unpacked);
+
+        mipmap::GenerateChain(chain.data(), pageWidth, pageHeight, 4, true);
+
+        GLuint texture;
+        glGenTextures(1, &texture);
+        TextureUnits::BindTextureForUpdate(texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        util::UploadTexture2DChain(pageWidth, pageHeight, 4, chain.data());
+        // smaller levels would mix texels of different images
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::min(maxMipLevel, mipmap::GetNumLevels(pageWidth, pageHeight) - 1));
+        pages.push_back(texture);
+    }
+
+    if (lgl::error::AnyGLError() != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error uploading %d atlas pages", GetNumPages());
+#endif
+        DeletePages();
+        return LGL_FAIL;
+    }
+    return LGL_SUCCESS;
+}
+
+void TextureAtlas::DeletePages()
+{
+    for (GLuint page : pages)
+        TextureUnits::ForgetTexture(page);
+    if (!pages.empty())
+        glDeleteTextures(static_cast<GLsizei>(pages.size()), pages.data());
+    pages.clear();
+}
+
+void TextureAtlas::Destroy()
+{
+    DeletePages();
+    images.clear();
+    rects.clear();
+}
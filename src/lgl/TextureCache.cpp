@@ -0,0 +1,125 @@
+#include "lgl/TextureCache.h"
+#include "lgl/Util.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/Types.h"
+
+using namespace lgl;
+
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::entries;
+std::unordered_map<GLuint, std::string> TextureCache::keys;
+std::list<std::string> TextureCache::lru;
+std::size_t TextureCache::budget = 256 * 1024 * 1024;
+TextureCacheStats TextureCache::stats = {0, 0, 0, 0};
+
+/**
+ * Estimate video memory of texture with full mipmap chain as lgl::util::UploadTexture2D() uploads it.
+ * It's stored as either GL_RGB or GL_RGBA, drivers typically pad GL_RGB texels to 4 bytes as well.
+ */
+static std::size_t EstimateTextureBytes(int width, int height)
+{
+    const std::size_t bytesPerTexel = 4;
+    const std::size_t baseBytes = static_cast<std::size_t>(width) * height * bytesPerTexel;
+    // mipmaps add up to a third of base level
+    return baseBytes + baseBytes / 3;
+}
+
+GLuint TextureCache::Acquire(const char* filepath)
+{
+    const std::string key(filepath);
+    auto it = entries.find(key);
+    if (it != entries.end())
+    {
+        Entry& entry = it->second;
+        if (entry.refCount == 0)
+            lru.erase(entry.lruIt);
+        ++entry.refCount;
+        ++stats.hits;
+        return entry.texture;
+    }
+
+    int width, height, nrChannels;
+    const GLuint texture = util::LoadTexture(filepath, &width, &height, &nrChannels);
+    if (texture == static_cast<GLuint>(LGL_FAIL))
+        return 0;
+
+    Entry& entry = entries[key];
+    entry.texture = texture;
+    entry.bytes = EstimateTextureBytes(width, height);
+    entry.refCount = 1;
+    keys[texture] = key;
+
+    ++stats.misses;
+    stats.bytesResident += entry.bytes;
+
+    // new texture is in use, make room for it among unused ones
+    Evict(budget);
+    return texture;
+}
+
+void TextureCache::Release(GLuint texture)
+{
+    auto keyIt = keys.find(texture);
+    if (keyIt == keys.end())
+        return;
+
+    Entry& entry = entries[keyIt->second];
+    if (entry.refCount == 0)
+        return;
+    if (--entry.refCount == 0)
+    {
+        entry.lruIt = lru.insert(lru.end(), keyIt->second);
+        Evict(budget);
+    }
+}
+
+void TextureCache::SetBudget(std::size_t bytes)
+{
+    budget = bytes;
+    Evict(budget);
+}
+
+std::size_t TextureCache::GetBudget()
+{
+    return budget;
+}
+
+void TextureCache::Clear()
+{
+    while (!lru.empty())
+        DeleteLeastRecentlyUsed();
+}
+
+void TextureCache::Evict(std::size_t maxBytes)
+{
+    if (maxBytes == 0)
+        return;
+
+    while (stats.bytesResident > maxBytes && !lru.empty())
+    {
+        DeleteLeastRecentlyUsed();
+        ++stats.evictions;
+    }
+}
+
+void TextureCache::DeleteLeastRecentlyUsed()
+{
+    auto it = entries.find(lru.front());
+    lru.pop_front();
+
+    TextureUnits::ForgetTexture(it->second.texture);
+    glDeleteTextures(1, &it->second.texture);
+    stats.bytesResident -= it->second.bytes;
+
+    keys.erase(it->second.texture);
+    entries.erase(it);
+}
+
+std::size_t TextureCache::GetNumTextures()
+{
+    return entries.size();
+}
+
+const TextureCacheStats& TextureCache::GetStats()
+{
+    return stats;
+}
@@ -0,0 +1,353 @@
+#include "lgl/TextureLoader.h"
+#include "lgl/Util.h"
+#include "lgl/Error.h"
+#include "lgl/Types.h"
+#include "lgl/Mipmap.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/Vfs.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace lgl;
+
+TextureLoader::TextureLoader():
+    stopping(false),
+    numPending(0),
+    isStreaming(false),
+    isCpuMipmap(false),
+    isSRGB(false),
+    stagingSize(0)
+{
+    // magenta stands out as not loaded yet
+    placeholderColor[0] = 255;
+    placeholderColor[1] = 0;
+    placeholderColor[2] = 255;
+    placeholderColor[3] = 255;
+
+    stats.requested = 0;
+    stats.resident = 0;
+    stats.failed = 0;
+    stats.decodeSeconds = 0.0;
+    stats.uploadSeconds = 0.0;
+    stats.streamed = 0;
+}
+
+TextureLoader::~TextureLoader()
+{
+    Stop();
+}
+
+void TextureLoader::Start(unsigned int numThreads)
+{
+    // stb_image of this version has only global flag, so set it once here instead of on each worker
+    // thread. It's the same as lgl::util::LoadTexture() sets.
+    stbi_set_flip_vertically_on_load(true);
+
+    stopping = false;
+    pool.Start(numThreads);
+}
+
+void TextureLoader::Stop()
+{
+    stopping = true;
+    pool.Stop();
+
+    // staged images live in pixel buffers, which are deleted altogether
+    for (const DecodedImage& image : decodedImages)
+    {
+        if (image.slot == LGL_FAIL)
+            FreePixels(image);
+    }
+    for (const DecodedImage& image : uploadQueue)
+    {
+        if (image.slot == LGL_FAIL)
+            FreePixels(image);
+    }
+    decodedImages.clear();
+    uploadQueue.clear();
+    numPending = 0;
+
+    if (isStreaming)
+    {
+        pixelBuffers.Destroy();
+        stagingBuffers.clear();
+        isStreaming = false;
+    }
+}
+
+void TextureLoader::EnableCpuMipmaps(bool isSRGB)
+{
+    isCpuMipmap = true;
+    this->isSRGB = isSRGB;
+}
+
+void TextureLoader::FreePixels(const DecodedImage& image)
+{
+    if (image.hasChain)
+        delete[] image.data;
+    else
+        stbi_image_free(image.data);
+}
+
+int TextureLoader::EnablePixelBufferStreaming(unsigned int numBuffers, std::size_t bufferSize)
+{
+    if (isStreaming)
+        return LGL_SUCCESS;
+
+    if (pixelBuffers.Create(numBuffers, bufferSize) != LGL_SUCCESS)
+        return LGL_FAIL;
+
+    isStreaming = true;
+    stagingSize = bufferSize;
+    RefillStagingBuffers();
+    return LGL_SUCCESS;
+}
+
+void TextureLoader::SetPlaceholderColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    placeholderColor[0] = r;
+    placeholderColor[1] = g;
+    placeholderColor[2] = b;
+    placeholderColor[3] = a;
+}
+
+GLuint TextureLoader::Load(const char* filepath)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    TextureUnits::BindTextureForUpdate(texture);
+
+    // the same texture filtering as lgl::util::LoadTexture()
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderColor);
+
+    states[texture] = STATE_PENDING;
+    ++numPending;
+    ++stats.requested;
+
+    const std::string path(filepath);
+    pool.Submit([this, texture, path]() { Decode(texture, path); });
+
+    return texture;
+}
+
+void TextureLoader::Decode(GLuint texture, const std::string& filepath)
+{
+    if (stopping)
+        return;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    DecodedImage image;
+    image.texture = texture;
+    image.slot = LGL_FAIL;
+    image.hasChain = false;
+    image.data = nullptr;
+    vfs::FileData file;
+    if (vfs::Open(filepath.c_str(), file) != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error loading %s [cannot open file]", filepath.c_str());
+#endif
+    }
+    else if ((image.data = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &image.width, &image.height, &image.nrChannels, 0)) == nullptr)
+    {
+#ifndef LGL_NODEBUG
+        // failure reason of stb_image is global, it might belong to another image decoded at the same time
+        lgl::error::ErrorWarn("Error loading %s [%s]", filepath.c_str(), stbi_failure_reason());
+#endif
+    }
+    else
+    {
+        std::size_t size = static_cast<std::size_t>(image.width) * image.height * image.nrChannels;
+        if (isCpuMipmap)
+        {
+            // stb_image cannot allocate extra space after its pixels, so move them into buffer of whole chain
+            unsigned char* chain = new unsigned char[mipmap::GetChainSize(image.width, image.height, image.nrChannels)];
+            std::memcpy(chain, image.data, size);
+            stbi_image_free(image.data);
+            mipmap::GenerateChain(chain, image.width, image.height, image.nrChannels, isSRGB);
+
+            image.data = chain;
+            image.hasChain = true;
+            size = mipmap::GetChainSize(image.width, image.height, image.nrChannels);
+        }
+
+        if (isStreaming)
+            Stage(image, size);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    decodedImages.push_back(image);
+    stats.decodeSeconds += seconds;
+}
+
+int TextureLoader::Update(double budgetSeconds)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        uploadQueue.insert(uploadQueue.end(), decodedImages.begin(), decodedImages.end());
+        decodedImages.clear();
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    int numUploaded = 0;
+
+    // time of the next upload is unknown, so stop once budget is used up
+    while (!uploadQueue.empty() && (numUploaded == 0 || elapsed < budgetSeconds))
+    {
+        const DecodedImage image = uploadQueue.front();
+        uploadQueue.pop_front();
+
+        Upload(image);
+        ++numUploaded;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    // map buffers released by uploads of previous frames for workers to stage into
+    if (isStreaming)
+        RefillStagingBuffers();
+
+    stats.uploadSeconds += elapsed;
+    return numUploaded;
+}
+
+void TextureLoader::Stage(DecodedImage& image, std::size_t size)
+{
+    StagingBuffer buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stagingSize = std::max(stagingSize, size);
+
+        auto it = std::find_if(stagingBuffers.begin(), stagingBuffers.end(),
+            [size](const StagingBuffer& b) { return b.capacity >= size; });
+        if (it == stagingBuffers.end())
+            return;
+        buffer = *it;
+        stagingBuffers.erase(it);
+    }
+
+    // stb_image only decodes into its own allocation, so copy it here while it's still in cache
+    // rather than on OpenGL thread
+    std::memcpy(buffer.data, image.data, size);
+    FreePixels(image);
+    image.data = static_cast<unsigned char*>(buffer.data);
+    image.slot = buffer.slot;
+}
+
+void TextureLoader::RefillStagingBuffers()
+{
+    std::size_t size;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size = stagingSize;
+
+        // give back buffers too small for the largest image seen, so they can be grown once acquired again
+        for (auto it = stagingBuffers.begin(); it != stagingBuffers.end(); )
+        {
+            if (it->capacity >= size)
+            {
+                ++it;
+                continue;
+            }
+            if (pixelBuffers.UnmapAndBind(it->slot) == LGL_SUCCESS)
+                pixelBuffers.Release(it->slot);
+            it = stagingBuffers.erase(it);
+        }
+    }
+
+    // map outside of lock, workers only wait for the append
+    std::vector<StagingBuffer> mapped;
+    for (;;)
+    {
+        const int slot = pixelBuffers.Acquire(size);
+        if (slot == LGL_FAIL)
+            break;
+
+        void* data = pixelBuffers.Map(slot);
+        if (data == nullptr)
+        {
+            pixelBuffers.Release(slot);
+            break;
+        }
+
+        StagingBuffer buffer;
+        buffer.slot = slot;
+        buffer.data = data;
+        buffer.capacity = pixelBuffers.GetCapacity(slot);
+        mapped.push_back(buffer);
+    }
+
+    if (!mapped.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stagingBuffers.insert(stagingBuffers.end(), mapped.begin(), mapped.end());
+    }
+}
+
+void TextureLoader::Upload(const DecodedImage& image)
+{
+    --numPending;
+
+    auto it = states.find(image.texture);
+    if (image.data == nullptr)
+    {
+        it->second = STATE_FAILED;
+        ++stats.failed;
+        return;
+    }
+
+    TextureUnits::BindTextureForUpdate(image.texture);
+    if (image.slot == LGL_FAIL)
+    {
+        if (image.hasChain)
+            util::UploadTexture2DChain(image.width, image.height, image.nrChannels, image.data);
+        else
+            util::UploadTexture2D(image.width, image.height, image.nrChannels, image.data);
+        FreePixels(image);
+    }
+    else
+    {
+        if (pixelBuffers.UnmapAndBind(image.slot) != LGL_SUCCESS)
+        {
+#ifndef LGL_NODEBUG
+            lgl::error::ErrorWarn("Pixel buffer of texture %u is corrupted while being mapped", image.texture);
+#endif
+            it->second = STATE_FAILED;
+            ++stats.failed;
+            return;
+        }
+
+        // nullptr as offset into bound pixel buffer, driver copies from it asynchronously
+        if (image.hasChain)
+            util::UploadTexture2DChain(image.width, image.height, image.nrChannels, nullptr);
+        else
+            util::UploadTexture2D(image.width, image.height, image.nrChannels, nullptr);
+        pixelBuffers.Release(image.slot);
+        ++stats.streamed;
+    }
+
+    it->second = STATE_RESIDENT;
+    ++stats.resident;
+}
+
+void TextureLoader::Finish()
+{
+    pool.WaitIdle();
+    while (numPending > 0 && Update(1.0) > 0)
+        ;
+}
+
+TextureLoader::State TextureLoader::GetState(GLuint texture) const
+{
+    auto it = states.find(texture);
+    return it != states.end() ? it->second : STATE_NONE;
+}
@@ -0,0 +1,107 @@
+#include "lgl/TextureUnits.h"
+
+using namespace lgl;
+
+// OpenGL never has this many units, marks active unit as unknown
+static const GLuint kUnknownUnit = ~0u;
+
+GLuint TextureUnits::activeUnit = kUnknownUnit;
+GLuint TextureUnits::textures[TextureUnits::kMaxUnits] = {};
+GLuint TextureUnits::samplers[TextureUnits::kMaxUnits] = {};
+std::uint32_t TextureUnits::knownTextures = 0;
+std::uint32_t TextureUnits::knownSamplers = 0;
+TextureBindStats TextureUnits::stats = {0, 0, 0, 0};
+
+void TextureUnits::BindTexture(GLuint unit, GLuint texture)
+{
+    if (IsShadowed(knownTextures, textures, unit, texture))
+    {
+        ++stats.bindsSkipped;
+        ++stats.unitSwitchesSkipped;
+        return;
+    }
+
+    ActivateUnit(unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    ++stats.bindsIssued;
+    Shadow(knownTextures, textures, unit, texture);
+}
+
+void TextureUnits::BindTextureForUpdate(GLuint texture)
+{
+    if (activeUnit != kUnknownUnit && IsShadowed(knownTextures, textures, activeUnit, texture))
+    {
+        ++stats.bindsSkipped;
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    ++stats.bindsIssued;
+    if (activeUnit != kUnknownUnit)
+        Shadow(knownTextures, textures, activeUnit, texture);
+}
+
+void TextureUnits::BindSampler(GLuint unit, GLuint sampler)
+{
+    if (IsShadowed(knownSamplers, samplers, unit, sampler))
+    {
+        ++stats.bindsSkipped;
+        return;
+    }
+
+    // takes unit directly, no need to make it active
+    glBindSampler(unit, sampler);
+    ++stats.bindsIssued;
+    Shadow(knownSamplers, samplers, unit, sampler);
+}
+
+void TextureUnits::ForgetTexture(GLuint texture)
+{
+    for (GLuint i=0; i<kMaxUnits; ++i)
+    {
+        if (textures[i] == texture)
+            textures[i] = 0;
+    }
+}
+
+void TextureUnits::ForgetSampler(GLuint sampler)
+{
+    for (GLuint i=0; i<kMaxUnits; ++i)
+    {
+        if (samplers[i] == sampler)
+            samplers[i] = 0;
+    }
+}
+
+void TextureUnits::Invalidate()
+{
+    activeUnit = kUnknownUnit;
+    knownTextures = 0;
+    knownSamplers = 0;
+}
+
+const TextureBindStats& TextureUnits::GetStats()
+{
+    return stats;
+}
+
+void TextureUnits::ResetStats()
+{
+    stats.bindsIssued = 0;
+    stats.bindsSkipped = 0;
+    stats.unitSwitchesIssued = 0;
+    stats.unitSwitchesSkipped = 0;
+}
+
+void TextureUnits::ActivateUnit(GLuint unit)
+{
+    if (activeUnit == unit)
+    {
+        ++stats.unitSwitchesSkipped;
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    ++stats.unitSwitchesIssued;
+    activeUnit = unit;
+}
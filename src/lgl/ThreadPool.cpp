@@ -0,0 +1,89 @@
+#include "lgl/ThreadPool.h"
+
+using namespace lgl;
+
+ThreadPool::ThreadPool():
+    numBusy(0),
+    stopping(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+void ThreadPool::Start(unsigned int numThreads)
+{
+    if (!threads.empty())
+        return;
+
+    if (numThreads == 0)
+    {
+        // hardware_concurrency() might return 0 if it cannot tell
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    stopping = false;
+    threads.reserve(numThreads);
+    for (unsigned int i=0; i<numThreads; ++i)
+        threads.emplace_back(&ThreadPool::WorkerMain, this);
+}
+
+void ThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (std::thread& thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+void ThreadPool::Submit(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return tasks.empty() && numBusy == 0; });
+}
+
+void ThreadPool::WorkerMain()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+            // drain remaining tasks before stopping
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++numBusy;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --numBusy;
+            if (tasks.empty() && numBusy == 0)
+                idle.notify_all();
+        }
+    }
+}
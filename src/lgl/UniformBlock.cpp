@@ -0,0 +1,125 @@
+#include "lgl/UniformBlock.h"
+#include "lgl/Error.h"
+#include "lgl/PBits.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace lgl;
+
+UniformBlock::UniformBlock():
+    ubo(0),
+    bindingPoint(0),
+    dirtyBegin(0),
+    dirtyEnd(0)
+{
+}
+
+int UniformBlock::Create(std::size_t size, GLuint bindingPoint, GLenum usage)
+{
+    Destroy();
+
+    this->bindingPoint = bindingPoint;
+    data.assign(size, 0);
+    dirtyBegin = 0;
+    dirtyEnd = 0;
+
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, size, data.data(), usage);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, ubo);
+    if (lgl::error::AnyGLError() != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error creating uniform block at binding point %u", bindingPoint);
+#endif
+        Destroy();
+        return LGL_FAIL;
+    }
+
+    return LGL_SUCCESS;
+}
+
+void UniformBlock::Destroy()
+{
+    if (ubo != 0)
+    {
+        glDeleteBuffers(1, &ubo);
+        ubo = 0;
+    }
+    data.clear();
+    dirtyBegin = 0;
+    dirtyEnd = 0;
+}
+
+void UniformBlock::Write(std::size_t offset, const void* value, std::size_t size)
+{
+    assert(offset + size <= data.size() && "value is written out of bound of uniform block");
+
+    // unchanged value doesn't need to be uploaded again
+    if (std::memcmp(data.data() + offset, value, size) == 0)
+        return;
+
+    std::memcpy(data.data() + offset, value, size);
+    if (dirtyBegin >= dirtyEnd)
+    {
+        dirtyBegin = offset;
+        dirtyEnd = offset + size;
+    }
+    else
+    {
+        dirtyBegin = std::min(dirtyBegin, offset);
+        dirtyEnd = std::max(dirtyEnd, offset + size);
+    }
+}
+
+void UniformBlock::Set(std::size_t offset, GLfloat value)
+{
+    Write(offset, &value, sizeof(value));
+}
+
+void UniformBlock::Set(std::size_t offset, GLint value)
+{
+    Write(offset, &value, sizeof(value));
+}
+
+void UniformBlock::Set(std::size_t offset, const glm::vec2& value)
+{
+    Write(offset, glm::value_ptr(value), sizeof(value));
+}
+
+void UniformBlock::Set(std::size_t offset, const glm::vec3& value)
+{
+    Write(offset, glm::value_ptr(value), sizeof(value));
+}
+
+void UniformBlock::Set(std::size_t offset, const glm::vec4& value)
+{
+    Write(offset, glm::value_ptr(value), sizeof(value));
+}
+
+void UniformBlock::Set(std::size_t offset, const glm::mat3& value)
+{
+    // each column is padded to vec4
+    for (int i=0; i<3; ++i)
+        Write(offset + i * 16, glm::value_ptr(value[i]), sizeof(value[i]));
+}
+
+void UniformBlock::Set(std::size_t offset, const glm::mat4& value)
+{
+    Write(offset, glm::value_ptr(value), sizeof(value));
+}
+
+void UniformBlock::Upload()
+{
+    if (dirtyBegin >= dirtyEnd)
+        return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, dirtyBegin, dirtyEnd - dirtyBegin, data.data() + dirtyBegin);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    dirtyBegin = 0;
+    dirtyEnd = 0;
+}
@@ -1,5 +1,16 @@
 #include "lgl/Util.h"
 #include "lgl/Error.h"
+#include "lgl/Ext.h"
+#include "lgl/BakedTexture.h"
+#include "lgl/Mipmap.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/Vfs.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // #define the following to bring in only what's needed for this implementation file
 #define LGL_EXTERNAL_STB_IMAGE_INCLUDE
@@ -13,13 +24,20 @@ GLuint lgl::util::LoadTexture(const char *filepath)
 
 GLuint lgl::util::LoadTexture(const char *filepath, int *width, int *height, int *nrChannels)
 {
+    vfs::FileData file;
+    if (vfs::Open(filepath, file) != LGL_SUCCESS)
+    {
+        lgl::error::ErrorWarn("Error loading %s [cannot open file]", filepath);
+        return LGL_FAIL;
+    }
+
     stbi_set_flip_vertically_on_load(true);
-    unsigned char *data = stbi_load(filepath, width, height, nrChannels, 0);
+    unsigned char *data = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), width, height, nrChannels, 0);
     if (data)
     {
         GLuint texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        TextureUnits::BindTextureForUpdate(texture);
 
         // set texture filtering on currently bound texture object
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -27,34 +45,7 @@ GLuint lgl::util::LoadTexture(const char *filepath, int *width, int *height, int
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        GLint internalformat = GL_RGB;
-        GLenum format;
-        // use pointer-dereference here multiple times not cache to some variable for readability
-        // and concise of code
-        if (*nrChannels == 1)
-        {
-            format = GL_RED;
-        }
-        else if (*nrChannels == 2)
-        {
-            format = GL_RG;
-        }
-        else if (*nrChannels == 3)
-        {
-            format = GL_RGB;
-        }
-        else if (*nrChannels == 4)
-        {
-            internalformat = GL_RGBA;
-            format = GL_RGBA;
-        }
-        else
-        {
-            format = GL_RGB;
-        }
-
-        glTexImage2D(GL_TEXTURE_2D, 0, internalformat, *width, *height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        UploadTexture2D(*width, *height, *nrChannels, data);
 
         stbi_image_free(data);
 
@@ -62,7 +53,263 @@ GLuint lgl::util::LoadTexture(const char *filepath, int *width, int *height, int
     }
     else
     {
-        lgl::error::ErrorWarn("Error loading ../data/container.jpg [%s]", stbi_failure_reason());
+        lgl::error::ErrorWarn("Error loading %s [%s]", filepath, stbi_failure_reason());
+        return LGL_FAIL;
+    }
+}
+
+/**
+ * Texture formats to upload 8-bit pixels of input number of channels with.
+ */
+static void GetTextureFormat(int nrChannels, GLint& internalformat, GLenum& format)
+{
+    internalformat = GL_RGB;
+    if (nrChannels == 1)
+    {
+        format = GL_RED;
+    }
+    else if (nrChannels == 2)
+    {
+        format = GL_RG;
+    }
+    else if (nrChannels == 3)
+    {
+        format = GL_RGB;
+    }
+    else if (nrChannels == 4)
+    {
+        internalformat = GL_RGBA;
+        format = GL_RGBA;
+    }
+    else
+    {
+        format = GL_RGB;
+    }
+}
+
+void lgl::util::UploadTexture2D(int width, int height, int nrChannels, const void* data)
+{
+    GLint internalformat;
+    GLenum format;
+    GetTextureFormat(nrChannels, internalformat, format);
+
+    // rows of tightly packed pixels are not 4-byte aligned as OpenGL expects by default
+    const bool isRowAligned = (width * nrChannels) % 4 == 0;
+    if (!isRowAligned)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, internalformat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    if (!isRowAligned)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void lgl::util::UploadTexture2DChain(int width, int height, int nrChannels, const void* chain)
+{
+    GLint internalformat;
+    GLenum format;
+    GetTextureFormat(nrChannels, internalformat, format);
+
+    // smaller levels are rarely 4-byte aligned even if base level is
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const int numLevels = lgl::mipmap::GetNumLevels(width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+
+    // chain can be nullptr as offset into pixel buffer
+    const char* level = static_cast<const char*>(chain);
+    for (int i=0; i<numLevels; ++i)
+    {
+        glTexImage2D(GL_TEXTURE_2D, i, internalformat, width, height, 0, format, GL_UNSIGNED_BYTE, level);
+        level += static_cast<std::size_t>(width) * height * nrChannels;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+/**
+ * Check that header and level table of baked texture are consistent, and all levels are within file.
+ */
+static bool IsBakedTextureValid(const unsigned char* bytes, std::size_t fileSize)
+{
+    using namespace lgl::baked;
+
+    if (fileSize < sizeof(FileHeader))
+        return false;
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(bytes);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->numLevels == 0 || header->numLevels > 32)
+        return false;
+    if (fileSize < sizeof(FileHeader) + sizeof(LevelHeader) * header->numLevels)
+        return false;
+
+    const LevelHeader* levels = reinterpret_cast<const LevelHeader*>(bytes + sizeof(FileHeader));
+    for (std::uint32_t i=0; i<header->numLevels; ++i)
+    {
+        if (levels[i].size != GetLevelSize(header->format, levels[i].width, levels[i].height) || levels[i].size == 0 ||
+            levels[i].offset > fileSize || levels[i].size > fileSize - levels[i].offset)
+            return false;
+    }
+    return true;
+}
+
+GLuint lgl::util::LoadBakedTexture(const char* filepath, int* width, int* height)
+{
+    using namespace lgl::baked;
+
+    vfs::FileData file;
+    if (vfs::Open(filepath, file) != LGL_SUCCESS)
+    {
+        lgl::error::ErrorWarn("Error opening %s", filepath);
+        return LGL_FAIL;
+    }
+
+    const unsigned char* bytes = file.GetData();
+    if (!IsBakedTextureValid(bytes, file.GetSize()))
+    {
+        lgl::error::ErrorWarn("Error loading %s [not a valid baked texture]", filepath);
         return LGL_FAIL;
     }
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(bytes);
+    const bool isCompressed = header->format == FORMAT_BC1 || header->format == FORMAT_BC3;
+    if (isCompressed && !lgl::ext::HasTextureCompressionS3TC())
+    {
+        lgl::error::ErrorWarn("Error loading %s [GL_EXT_texture_compression_s3tc is not supported]", filepath);
+        return LGL_FAIL;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    TextureUnits::BindTextureForUpdate(texture);
+
+    // the same texture filtering as LoadTexture()
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(header->numLevels) - 1);
+
+    // rows of RGB8 levels are tightly packed
+    if (header->format == FORMAT_RGB8)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const LevelHeader* levels = reinterpret_cast<const LevelHeader*>(bytes + sizeof(FileHeader));
+    for (std::uint32_t i=0; i<header->numLevels; ++i)
+    {
+        const GLint level = static_cast<GLint>(i);
+        const GLsizei w = static_cast<GLsizei>(levels[i].width);
+        const GLsizei h = static_cast<GLsizei>(levels[i].height);
+        const unsigned char* data = bytes + levels[i].offset;
+        switch (header->format)
+        {
+        case FORMAT_RGB8:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGB, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+            break;
+        case FORMAT_RGBA8:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            break;
+        case FORMAT_BC1:
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, w, h, 0, static_cast<GLsizei>(levels[i].size), data);
+            break;
+        case FORMAT_BC3:
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, w, h, 0, static_cast<GLsizei>(levels[i].size), data);
+            break;
+        }
+    }
+
+    if (header->format == FORMAT_RGB8)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (width != nullptr)
+        *width = static_cast<int>(header->width);
+    if (height != nullptr)
+        *height = static_cast<int>(header->height);
+
+    return texture;
+}
+
+lgl::util::FileView::FileView():
+    data(nullptr),
+    size(0),
+    isMapped(false)
+{
+}
+
+lgl::util::FileView::~FileView()
+{
+    Close();
+}
+
+lgl::util::FileView::FileView(FileView&& other):
+    data(other.data),
+    size(other.size),
+    isMapped(other.isMapped)
+{
+    other.data = nullptr;
+    other.size = 0;
+    other.isMapped = false;
+}
+
+lgl::util::FileView& lgl::util::FileView::operator=(FileView&& other)
+{
+    if (this != &other)
+    {
+        Close();
+        data = other.data;
+        size = other.size;
+        isMapped = other.isMapped;
+        other.data = nullptr;
+        other.size = 0;
+        other.isMapped = false;
+    }
+    return *this;
+}
+
+int lgl::util::FileView::Open(const char* filePath)
+{
+    Close();
+
+    const int fd = open(filePath, O_RDONLY);
+    if (fd == -1)
+        return LGL_FAIL;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+    {
+        close(fd);
+        return LGL_FAIL;
+    }
+
+    if (st.st_size == 0)
+    {
+        close(fd);
+        data = "";
+        return LGL_SUCCESS;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return LGL_FAIL;
+
+    // it's read from start to end in most cases
+    madvise(mapped, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    data = static_cast<const char*>(mapped);
+    size = static_cast<std::size_t>(st.st_size);
+    isMapped = true;
+    return LGL_SUCCESS;
+}
+
+void lgl::util::FileView::Close()
+{
+    if (isMapped)
+        munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    isMapped = false;
 }
@@ -0,0 +1,271 @@
+#include "lgl/Vfs.h"
+#include "lgl/PackFile.h"
+#include "lgl/Lz4.h"
+#include "lgl/Error.h"
+#include "lgl/Types.h"
+#include <cstring>
+#include <sys/stat.h>
+#include <unordered_map>
+
+using namespace lgl;
+
+namespace
+{
+
+struct Mount
+{
+    std::string mountPoint;     // without trailing '/'
+    std::string directory;      // empty for archive
+    util::FileView archive;
+    std::unordered_map<std::string, const pack::Entry*> entries;
+};
+
+std::vector<Mount> mounts;
+
+/**
+ * Strip leading "./" and trailing '/' so the same file is always looked up with the same path.
+ */
+std::string Normalize(const char* path)
+{
+    while (path[0] == '.' && path[1] == '/')
+        path += 2;
+    std::string normalized(path);
+    while (!normalized.empty() && normalized.back() == '/')
+        normalized.pop_back();
+    return normalized;
+}
+
+/**
+ * Get path relative to mount point of mount.
+ *
+ * \return Whether path is under mount point
+ */
+bool GetRelativePath(const Mount& mount, const std::string& path, std::string& relative)
+{
+    if (mount.mountPoint.empty())
+    {
+        // absolute path is never rebased onto mounted directory
+        if (!path.empty() && path[0] == '/')
+            return false;
+        relative = path;
+        return true;
+    }
+    const std::size_t n = mount.mountPoint.size();
+    if (path.size() <= n || path.compare(0, n, mount.mountPoint) != 0 || path[n] != '/')
+        return false;
+    relative = path.substr(n + 1);
+    return true;
+}
+
+bool IsArchiveValid(const unsigned char* bytes, std::size_t size)
+{
+    if (size < sizeof(pack::Header))
+        return false;
+    const pack::Header* header = reinterpret_cast<const pack::Header*>(bytes);
+    if (std::memcmp(header->magic, pack::kMagic, sizeof(pack::kMagic)) != 0 || header->version != pack::kVersion)
+        return false;
+
+    const std::uint64_t tablesEnd = sizeof(pack::Header) + static_cast<std::uint64_t>(header->numEntries) * sizeof(pack::Entry) +
+                                    header->stringTableSize;
+    if (tablesEnd > size)
+        return false;
+
+    const pack::Entry* entries = reinterpret_cast<const pack::Entry*>(bytes + sizeof(pack::Header));
+    for (std::uint32_t i=0; i<header->numEntries; ++i)
+    {
+        const pack::Entry& entry = entries[i];
+        if (static_cast<std::uint64_t>(entry.nameOffset) + entry.nameLength > header->stringTableSize)
+            return false;
+        if (entry.offset > size || entry.storedSize > size - entry.offset)
+            return false;
+        if (entry.compression == pack::COMPRESSION_NONE && entry.storedSize != entry.size)
+            return false;
+        if (entry.compression != pack::COMPRESSION_NONE && entry.compression != pack::COMPRESSION_LZ4)
+            return false;
+        // LZ4 expands at most about 255 times, so corrupted size isn't allocated
+        if (entry.compression == pack::COMPRESSION_LZ4 && entry.size / 256 > entry.storedSize)
+            return false;
+    }
+    return true;
+}
+
+const pack::Entry* FindEntry(const Mount& mount, const std::string& relative)
+{
+    auto it = mount.entries.find(relative);
+    return it != mount.entries.end() ? it->second : nullptr;
+}
+
+bool IsFile(const char* path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+}
+
+vfs::FileData::FileData():
+    data(nullptr),
+    size(0)
+{
+}
+
+vfs::FileData::FileData(FileData&& other):
+    data(other.data),
+    size(other.size),
+    storage(std::move(other.storage)),
+    view(std::move(other.view))
+{
+    other.data = nullptr;
+    other.size = 0;
+}
+
+vfs::FileData& vfs::FileData::operator=(FileData&& other)
+{
+    if (this != &other)
+    {
+        // moving vector keeps its buffer, so data still points to it
+        data = other.data;
+        size = other.size;
+        storage = std::move(other.storage);
+        view = std::move(other.view);
+        other.data = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+int vfs::MountDirectory(const char* directory, const char* mountPoint)
+{
+    struct stat st;
+    if (stat(directory, &st) != 0 || !S_ISDIR(st.st_mode))
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot mount %s [not a directory]", directory);
+#endif
+        return LGL_FAIL;
+    }
+
+    Mount mount;
+    mount.mountPoint = Normalize(mountPoint);
+    mount.directory = Normalize(directory);
+    if (mount.directory.empty())
+        mount.directory = "/";
+    mounts.push_back(std::move(mount));
+    return LGL_SUCCESS;
+}
+
+int vfs::MountArchive(const char* filepath, const char* mountPoint)
+{
+    Mount mount;
+    if (mount.archive.Open(filepath) != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot mount %s", filepath);
+#endif
+        return LGL_FAIL;
+    }
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(mount.archive.GetData());
+    if (!IsArchiveValid(bytes, mount.archive.GetSize()))
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Cannot mount %s [not a valid packed archive]", filepath);
+#endif
+        return LGL_FAIL;
+    }
+
+    const pack::Header* header = reinterpret_cast<const pack::Header*>(bytes);
+    const pack::Entry* entries = reinterpret_cast<const pack::Entry*>(bytes + sizeof(pack::Header));
+    const char* names = reinterpret_cast<const char*>(entries + header->numEntries);
+    mount.entries.reserve(header->numEntries);
+    for (std::uint32_t i=0; i<header->numEntries; ++i)
+        mount.entries[std::string(names + entries[i].nameOffset, entries[i].nameLength)] = &entries[i];
+
+    mount.mountPoint = Normalize(mountPoint);
+    mounts.push_back(std::move(mount));
+    return LGL_SUCCESS;
+}
+
+void vfs::UnmountAll()
+{
+    mounts.clear();
+}
+
+bool vfs::Exists(const char* path)
+{
+    const std::string normalized = Normalize(path);
+    std::string relative;
+    for (auto it = mounts.rbegin(); it != mounts.rend(); ++it)
+    {
+        if (!GetRelativePath(*it, normalized, relative))
+            continue;
+        if (it->directory.empty() ? FindEntry(*it, relative) != nullptr : IsFile((it->directory + '/' + relative).c_str()))
+            return true;
+    }
+    return IsFile(path);
+}
+
+int vfs::Open(const char* path, FileData& file)
+{
+    file = FileData();
+
+    const std::string normalized = Normalize(path);
+    std::string relative;
+    for (auto it = mounts.rbegin(); it != mounts.rend(); ++it)
+    {
+        if (!GetRelativePath(*it, normalized, relative))
+            continue;
+
+        if (!it->directory.empty())
+        {
+            if (file.view.Open((it->directory + '/' + relative).c_str()) != LGL_SUCCESS)
+                continue;
+            file.data = reinterpret_cast<const unsigned char*>(file.view.GetData());
+            file.size = file.view.GetSize();
+            return LGL_SUCCESS;
+        }
+
+        const pack::Entry* entry = FindEntry(*it, relative);
+        if (entry == nullptr)
+            continue;
+
+        const unsigned char* blob = reinterpret_cast<const unsigned char*>(it->archive.GetData()) + entry->offset;
+        if (entry->compression == pack::COMPRESSION_NONE)
+        {
+            file.data = blob;
+            file.size = static_cast<std::size_t>(entry->size);
+            return LGL_SUCCESS;
+        }
+
+        file.storage.resize(static_cast<std::size_t>(entry->size));
+        if (lz4::DecompressBlock(blob, static_cast<std::size_t>(entry->storedSize), file.storage.data(), file.storage.size()) != LGL_SUCCESS)
+        {
+#ifndef LGL_NODEBUG
+            lgl::error::ErrorWarn("Cannot read %s [corrupted entry in packed archive]", path);
+#endif
+            file = FileData();
+            return LGL_FAIL;
+        }
+        file.data = file.storage.data();
+        file.size = file.storage.size();
+        return LGL_SUCCESS;
+    }
+
+    if (file.view.Open(path) != LGL_SUCCESS)
+        return LGL_FAIL;
+    file.data = reinterpret_cast<const unsigned char*>(file.view.GetData());
+    file.size = file.view.GetSize();
+    return LGL_SUCCESS;
+}
+
+int vfs::ReadText(const char* path, std::string& text)
+{
+    FileData file;
+    if (Open(path, file) != LGL_SUCCESS)
+        return LGL_FAIL;
+
+    text.assign(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+    if (!text.empty() && text.back() != '\n')
+        text += '\n';
+    return LGL_SUCCESS;
+}
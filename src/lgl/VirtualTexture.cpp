@@ -0,0 +1,534 @@
+#include "lgl/VirtualTexture.h"
+#include "lgl/Shader.h"
+#include "lgl/TextureUnits.h"
+#include "lgl/Error.h"
+#include "lgl/Types.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace lgl;
+
+/**
+ * Whether page file header is consistent, and file holds all of its pages.
+ */
+static bool IsPageFileValid(const unsigned char* bytes, std::size_t size)
+{
+    if (size < paged::kDataOffset)
+        return false;
+    const paged::FileHeader* header = reinterpret_cast<const paged::FileHeader*>(bytes);
+    if (std::memcmp(header->magic, paged::kMagic, sizeof(paged::kMagic)) != 0 || header->version != paged::kVersion)
+        return false;
+    if (header->pageSize == 0 || header->border > header->pageSize || header->numLevels == 0 || header->numLevels > 9)
+        return false;
+    if (header->pagesX == 0 || header->pagesY == 0 || header->pagesX > paged::kMaxPages || header->pagesY > paged::kMaxPages)
+        return false;
+
+    // each level must have exactly half pages of the previous one
+    const std::uint32_t multiple = 1u << (header->numLevels - 1);
+    if (header->pagesX % multiple != 0 || header->pagesY % multiple != 0)
+        return false;
+
+    return paged::kDataOffset + paged::GetNumPages(*header) * paged::GetPageBytes(*header) <= size;
+}
+
+VirtualTexture::VirtualTexture():
+    pageTable(0),
+    physical(0),
+    cacheSize(0),
+    isTableDirty(false),
+    frame(0),
+    numLoading(0),
+    feedbackFramebuffer(0),
+    feedbackColor(0),
+    feedbackDepth(0),
+    feedbackWidth(0),
+    feedbackHeight(0),
+    feedbackLodBias(0.0f),
+    readbackIndex(0),
+    savedFramebuffer(0)
+{
+    std::memset(&header, 0, sizeof(header));
+    readbackBuffers[0] = readbackBuffers[1] = 0;
+    readbackFences[0] = readbackFences[1] = nullptr;
+    std::memset(&stats, 0, sizeof(stats));
+}
+
+VirtualTexture::~VirtualTexture()
+{
+    Destroy();
+}
+
+int VirtualTexture::Create(const char* filepath, int cacheSize, int feedbackWidth, int feedbackHeight, unsigned int numThreads)
+{
+    Destroy();
+
+    if (vfs::Open(filepath, file) != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error opening %s", filepath);
+#endif
+        return LGL_FAIL;
+    }
+    if (!IsPageFileValid(file.GetData(), file.GetSize()))
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error loading %s [not a valid page file]", filepath);
+#endif
+        file = vfs::FileData();
+        return LGL_FAIL;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    const std::uint32_t coarsest = header.numLevels - 1;
+    const std::uint32_t numPinned = (header.pagesX >> coarsest) * (header.pagesY >> coarsest);
+    const int side = static_cast<int>(header.pageSize + 2 * header.border);
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    // the coarsest level must leave room for pages to stream in
+    if (cacheSize <= 0 || cacheSize > 256 || cacheSize * side > maxTextureSize ||
+        numPinned > static_cast<std::uint32_t>(cacheSize * cacheSize / 2))
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error loading %s [physical cache of %dx%d pages is either too small or too large]", filepath, cacheSize, cacheSize);
+#endif
+        file = vfs::FileData();
+        return LGL_FAIL;
+    }
+
+    this->cacheSize = cacheSize;
+    this->feedbackWidth = feedbackWidth;
+    this->feedbackHeight = feedbackHeight;
+
+    const std::uint32_t numPages = paged::GetNumPages(header);
+    levelFirstPage.resize(header.numLevels + 1);
+    for (std::uint32_t l=0; l<=header.numLevels; ++l)
+        levelFirstPage[l] = paged::GetFirstPage(header, l);
+    pageSlots.assign(numPages, LGL_FAIL);
+    pageLoading.assign(numPages, 0);
+    pageRequested.assign(numPages, 0);
+    tableLevels.resize(header.numLevels);
+    Slot freeSlot = { LGL_FAIL, 0, false };
+    slots.assign(static_cast<std::size_t>(cacheSize) * cacheSize, freeSlot);
+    frame = 1;
+
+    // page table, nearest texel of each level is the page to look up
+    glGenTextures(1, &pageTable);
+    TextureUnits::BindTextureForUpdate(pageTable);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(coarsest));
+    for (std::uint32_t l=0; l<header.numLevels; ++l)
+    {
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(l), GL_RGBA, static_cast<GLsizei>(header.pagesX >> l), static_cast<GLsizei>(header.pagesY >> l),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    // physical cache, borders of pages make bilinear filtering within a page seamless
+    glGenTextures(1, &physical);
+    TextureUnits::BindTextureForUpdate(physical);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cacheSize * side, cacheSize * side, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    // the coarsest level is always resident, so every page has something to fall back to
+    const unsigned char* pages = file.GetData() + paged::kDataOffset;
+    for (std::uint32_t i=0; i<numPinned; ++i)
+    {
+        const std::uint32_t page = levelFirstPage[coarsest] + i;
+        UploadPage(page, pages + page * paged::GetPageBytes(header), static_cast<int>(i));
+        slots[i].isPinned = true;
+    }
+    UpdatePageTable();
+
+    // feedback framebuffer with depth so only visible surfaces request pages
+    glGenRenderbuffers(1, &feedbackColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, feedbackColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, feedbackWidth, feedbackHeight);
+    glGenRenderbuffers(1, &feedbackDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, feedbackDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, feedbackWidth, feedbackHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint framebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+    glGenFramebuffers(1, &feedbackFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, feedbackFramebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, feedbackColor);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, feedbackDepth);
+    const bool isComplete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(framebuffer));
+
+    glGenBuffers(2, readbackBuffers);
+    for (GLuint buffer : readbackBuffers)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(feedbackWidth) * feedbackHeight * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!isComplete || lgl::error::AnyGLError() != LGL_SUCCESS)
+    {
+#ifndef LGL_NODEBUG
+        lgl::error::ErrorWarn("Error creating virtual texture of %s", filepath);
+#endif
+        Destroy();
+        return LGL_FAIL;
+    }
+
+    pool.Start(numThreads);
+    return LGL_SUCCESS;
+}
+
+void VirtualTexture::Destroy()
+{
+    // workers read from file, so they must be done before it's closed
+    pool.Stop();
+    loadedPages.clear();
+    numLoading = 0;
+
+    for (int i=0; i<2; ++i)
+    {
+        if (readbackFences[i] != nullptr)
+        {
+            glDeleteSync(readbackFences[i]);
+            readbackFences[i] = nullptr;
+        }
+    }
+    if (readbackBuffers[0] != 0)
+    {
+        glDeleteBuffers(2, readbackBuffers);
+        readbackBuffers[0] = readbackBuffers[1] = 0;
+    }
+    if (feedbackFramebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &feedbackFramebuffer);
+        feedbackFramebuffer = 0;
+    }
+    if (feedbackColor != 0)
+    {
+        glDeleteRenderbuffers(1, &feedbackColor);
+        feedbackColor = 0;
+    }
+    if (feedbackDepth != 0)
+    {
+        glDeleteRenderbuffers(1, &feedbackDepth);
+        feedbackDepth = 0;
+    }
+    if (pageTable != 0)
+    {
+        TextureUnits::ForgetTexture(pageTable);
+        glDeleteTextures(1, &pageTable);
+        pageTable = 0;
+    }
+    if (physical != 0)
+    {
+        TextureUnits::ForgetTexture(physical);
+        glDeleteTextures(1, &physical);
+        physical = 0;
+    }
+
+    slots.clear();
+    pageSlots.clear();
+    pageLoading.clear();
+    pageRequested.clear();
+    levelFirstPage.clear();
+    tableLevels.clear();
+    missingPages.clear();
+    file = vfs::FileData();
+    std::memset(&stats, 0, sizeof(stats));
+}
+
+void VirtualTexture::BeginFeedback()
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &savedFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, savedViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, savedClearColor);
+
+    // derivatives are larger at low resolution, bias them back to what full resolution would pick
+    feedbackLodBias = savedViewport[2] > 0 ? -std::log2(static_cast<float>(savedViewport[2]) / feedbackWidth) : 0.0f;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, feedbackFramebuffer);
+    glViewport(0, 0, feedbackWidth, feedbackHeight);
+    // zero alpha marks pixels without virtual texture
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void VirtualTexture::EndFeedback()
+{
+    // previous feedback in this buffer wasn't consumed in time, newer one replaces it
+    if (readbackFences[readbackIndex] != nullptr)
+    {
+        glDeleteSync(readbackFences[readbackIndex]);
+        readbackFences[readbackIndex] = nullptr;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[readbackIndex]);
+    glReadPixels(0, 0, feedbackWidth, feedbackHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readbackFences[readbackIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readbackIndex ^= 1;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(savedFramebuffer));
+    glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+    glClearColor(savedClearColor[0], savedClearColor[1], savedClearColor[2], savedClearColor[3]);
+}
+
+int VirtualTexture::Update(int maxUploads)
+{
+    if (pageTable == 0)
+        return 0;
+
+    ++frame;
+    ConsumeFeedback();
+
+    // read missing pages ahead, but not too many as feedback may change its mind
+    for (std::uint32_t page : missingPages)
+    {
+        if (numLoading >= static_cast<unsigned int>(maxUploads) * 2)
+            break;
+        if (pageSlots[page] != LGL_FAIL || pageLoading[page] != 0)
+            continue;
+        pageLoading[page] = 1;
+        ++numLoading;
+        pool.Submit([this, page]() { LoadPage(page); });
+    }
+
+    std::vector<LoadedPage> pages;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::size_t n = std::min(loadedPages.size(), static_cast<std::size_t>(std::max(maxUploads, 0)));
+        pages.reserve(n);
+        for (std::size_t i=0; i<n; ++i)
+            pages.push_back(std::move(loadedPages[i]));
+        loadedPages.erase(loadedPages.begin(), loadedPages.begin() + n);
+    }
+
+    int numUploaded = 0;
+    for (const LoadedPage& loaded : pages)
+    {
+        --numLoading;
+        pageLoading[loaded.page] = 0;
+        if (pageSlots[loaded.page] != LGL_FAIL)
+            continue;
+
+        // every slot is needed by current frame, drop it until some isn't
+        const int slot = FindSlot();
+        if (slot == LGL_FAIL)
+            continue;
+        UploadPage(loaded.page, loaded.data.data(), slot);
+        ++numUploaded;
+    }
+
+    if (isTableDirty)
+        UpdatePageTable();
+    return numUploaded;
+}
+
+void VirtualTexture::Bind(Shader& shader, int firstUnit)
+{
+    TextureUnits::BindTexture(static_cast<GLuint>(firstUnit), pageTable);
+    TextureUnits::BindTexture(static_cast<GLuint>(firstUnit) + 1, physical);
+
+    shader.SetUniform("vtPageTable", firstUnit);
+    shader.SetUniform("vtPhysical", firstUnit + 1);
+    SetUniforms(shader, 0.0f);
+}
+
+void VirtualTexture::BindFeedback(Shader& shader)
+{
+    SetUniforms(shader, feedbackLodBias);
+}
+
+void VirtualTexture::SetUniforms(Shader& shader, float lodBias)
+{
+    const float side = static_cast<float>(header.pageSize + 2 * header.border);
+    GLint location = shader.GetUniformLocation("vtInfo");
+    if (location != LGL_FAIL)
+        shader.SetUniform(location, glm::vec4(header.pagesX, header.pagesY, header.numLevels - 1, lodBias));
+    location = shader.GetUniformLocation("vtUvScale");
+    if (location != LGL_FAIL)
+        shader.SetUniform(location, glm::vec2(static_cast<float>(header.width) / (header.pagesX * header.pageSize),
+                                              static_cast<float>(header.height) / (header.pagesY * header.pageSize)));
+    location = shader.GetUniformLocation("vtPage");
+    if (location != LGL_FAIL)
+        shader.SetUniform(location, glm::vec4(header.pageSize, header.border, side, side * cacheSize));
+}
+
+void VirtualTexture::ConsumeFeedback()
+{
+    bool isConsumed = false;
+    // older one first
+    for (int i=0; i<2; ++i)
+    {
+        const int index = (readbackIndex + i) % 2;
+        if (readbackFences[index] == nullptr)
+            continue;
+
+        // only check, never wait
+        const GLenum result = glClientWaitSync(readbackFences[index], 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+            continue;
+        glDeleteSync(readbackFences[index]);
+        readbackFences[index] = nullptr;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[index]);
+        const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(feedbackWidth) * feedbackHeight * 4, GL_MAP_READ_BIT);
+        if (pixels != nullptr)
+        {
+            if (!isConsumed)
+            {
+                missingPages.clear();
+                stats.requested = 0;
+                stats.missing = 0;
+                isConsumed = true;
+            }
+            ProcessFeedback(static_cast<const unsigned char*>(pixels));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            ++stats.feedbacks;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    if (isConsumed)
+    {
+        // coarser levels are at higher indices, and are streamed first so detail refines progressively
+        std::sort(missingPages.begin(), missingPages.end(), [](std::uint32_t a, std::uint32_t b) { return a > b; });
+    }
+}
+
+void VirtualTexture::ProcessFeedback(const unsigned char* pixels)
+{
+    const std::size_t numPixels = static_cast<std::size_t>(feedbackWidth) * feedbackHeight;
+    for (std::size_t i=0; i<numPixels; ++i)
+    {
+        const unsigned char* pixel = pixels + i * 4;
+        if (pixel[3] == 0)
+            continue;
+
+        std::uint32_t x = pixel[0];
+        std::uint32_t y = pixel[1];
+        std::uint32_t level = pixel[2];
+        if (level >= header.numLevels || x >= (header.pagesX >> level) || y >= (header.pagesY >> level))
+            continue;
+
+        const std::uint32_t page = GetPageIndex(level, x, y);
+        if (pageRequested[page] == frame)
+            continue;
+        pageRequested[page] = frame;
+        ++stats.requested;
+
+        if (pageSlots[page] == LGL_FAIL)
+        {
+            missingPages.push_back(page);
+            ++stats.missing;
+        }
+
+        // keep what's shown in place of it, itself or its nearest resident coarser page
+        for (;;)
+        {
+            const int slot = pageSlots[GetPageIndex(level, x, y)];
+            if (slot != LGL_FAIL)
+            {
+                slots[slot].lastUsed = frame;
+                break;
+            }
+            ++level;
+            x /= 2;
+            y /= 2;
+        }
+    }
+}
+
+void VirtualTexture::LoadPage(std::uint32_t page)
+{
+    LoadedPage loaded;
+    loaded.page = page;
+    // copying from mapped file is what reads it from disk, off OpenGL thread
+    const std::size_t pageBytes = static_cast<std::size_t>(paged::GetPageBytes(header));
+    const unsigned char* src = file.GetData() + paged::kDataOffset + page * pageBytes;
+    loaded.data.assign(src, src + pageBytes);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    loadedPages.push_back(std::move(loaded));
+}
+
+int VirtualTexture::FindSlot()
+{
+    int best = LGL_FAIL;
+    for (std::size_t i=0; i<slots.size(); ++i)
+    {
+        const Slot& slot = slots[i];
+        if (slot.page == LGL_FAIL)
+            return static_cast<int>(i);
+        if (slot.isPinned || slot.lastUsed == frame)
+            continue;
+        if (best == LGL_FAIL || slot.lastUsed < slots[best].lastUsed)
+            best = static_cast<int>(i);
+    }
+    return best;
+}
+
+void VirtualTexture::UploadPage(std::uint32_t page, const unsigned char* data, int slot)
+{
+    Slot& s = slots[slot];
+    if (s.page != LGL_FAIL)
+    {
+        pageSlots[s.page] = LGL_FAIL;
+        ++stats.evicted;
+    }
+    else
+    {
+        ++stats.resident;
+    }
+    s.page = static_cast<int>(page);
+    s.lastUsed = frame;
+    pageSlots[page] = slot;
+
+    const int side = static_cast<int>(header.pageSize + 2 * header.border);
+    TextureUnits::BindTextureForUpdate(physical);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % cacheSize) * side, (slot / cacheSize) * side, side, side, GL_RGBA, GL_UNSIGNED_BYTE, data);
+
+    ++stats.uploaded;
+    isTableDirty = true;
+}
+
+void VirtualTexture::UpdatePageTable()
+{
+    TextureUnits::BindTextureForUpdate(pageTable);
+    // from the coarsest level, so each non-resident page inherits entry of its coarser page
+    for (std::uint32_t l=header.numLevels; l-- > 0;)
+    {
+        const std::uint32_t width = header.pagesX >> l;
+        const std::uint32_t height = header.pagesY >> l;
+        std::vector<std::uint32_t>& level = tableLevels[l];
+        level.resize(static_cast<std::size_t>(width) * height);
+        for (std::uint32_t y=0; y<height; ++y)
+        {
+            for (std::uint32_t x=0; x<width; ++x)
+            {
+                const int slot = pageSlots[GetPageIndex(l, x, y)];
+                if (slot != LGL_FAIL)
+                {
+                    // RGBA8 as little-endian: slot x, slot y, level of page, marker
+                    level[y * width + x] = static_cast<std::uint32_t>(slot % cacheSize) | (static_cast<std::uint32_t>(slot / cacheSize) << 8) |
+                                           (l << 16) | (0xFFu << 24);
+                }
+                else
+                {
+                    // the coarsest level is pinned, so it never gets here
+                    level[y * width + x] = tableLevels[l + 1][(y / 2) * (width / 2) + x / 2];
+                }
+            }
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(l), 0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                        GL_RGBA, GL_UNSIGNED_BYTE, level.data());
+    }
+    isTableDirty = false;
+}